@@ -0,0 +1,159 @@
+#include "AnalysisTask.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+/*======================================================================
+   AnalysisTask – tranches de temps, échéance, annulation
+======================================================================*/
+AnalysisTask::Status AnalysisTask::resume(Clock::duration slice) {
+    if (finished()) return current;
+    const Clock::time_point end = Clock::now() + slice;
+    do {
+        if (cancelRequested) return current = Status::Cancelled;
+        ++stepCount;
+        if (step()) return current = Status::Done;
+    } while (Clock::now() < end);
+    return current;
+}
+
+AnalysisTask::Status AnalysisTask::run(Clock::time_point deadline, const ProgressFn& onProgress,
+                                       Clock::duration every) {
+    while (!finished()) {
+        Clock::time_point now = Clock::now();
+        if (now >= deadline) return current = Status::DeadlineExceeded;
+        Clock::duration slice = std::min<Clock::duration>(every, deadline - now);
+        resume(slice);
+        if (onProgress) onProgress(*this);
+    }
+    return current;
+}
+
+/*======================================================================
+   MaxFlowTask
+======================================================================*/
+MaxFlowTask::MaxFlowTask(std::shared_ptr<const GraphSnapshot> snapshot, int source, int sink)
+    : keep(snapshot), graph(*keep) { init(source, sink); }
+
+MaxFlowTask::MaxFlowTask(const GraphSnapshot& snapshot, int source, int sink)
+    : graph(snapshot) { init(source, sink); }
+
+// arc 2k : arête k du CSR, arc 2k+1 : son arc inverse
+void MaxFlowTask::init(int source, int sink) {
+    s = graph.indexOf(source);
+    t = graph.indexOf(sink);
+    if (s < 0 || t < 0 || s == t) return;           // premier pas : terminé, débit 0
+    if (!graph.connected(s, t)) { t = -1; return; } // autre composante : idem
+
+    const int n = static_cast<int>(graph.nodeCount());
+    const int m = static_cast<int>(graph.edgeCount());
+    start.assign(n + 1, 0);
+    arcs.resize(2 * m);
+    head.resize(2 * m);
+    residual.resize(2 * m);
+    for (int u = 0; u < n; ++u)
+        for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) { ++start[u + 1]; ++start[graph.target(e) + 1]; }
+    for (int u = 0; u < n; ++u) start[u + 1] += start[u];
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    for (int u = 0; u < n; ++u)
+        for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+            int v = graph.target(e);
+            head[2 * e]     = v; residual[2 * e]     = graph.capacity(e); arcs[fill[u]++] = 2 * e;
+            head[2 * e + 1] = u; residual[2 * e + 1] = 0;                 arcs[fill[v]++] = 2 * e + 1;
+        }
+    via.resize(n);
+    queue.resize(n);                              // chaque nœud entre au plus une fois
+}
+
+bool MaxFlowTask::step() {
+    if (s < 0 || t < 0 || s == t) return true;
+
+    // copies locales : le compilateur ne relit pas les membres à chaque arc
+    const int* const       first = start.data();
+    const int* const       arc   = arcs.data();
+    const int* const       to    = head.data();
+    const long long* const cap   = residual.data();
+    int* const             from  = via.data();
+    int* const             fifo  = queue.data();
+
+    std::fill(via.begin(), via.end(), -1);          // via[v] : arc d'arrivée
+    from[s] = -2;
+    fifo[0] = s;
+    for (int q = 0, tail = 1; q < tail && from[t] == -1; ++q) {
+        int u = fifo[q];
+        for (int k = first[u]; k < first[u + 1]; ++k) {
+            int a = arc[k], v = to[a];
+            if (from[v] == -1 && cap[a] > 0) { from[v] = a; fifo[tail++] = v; }
+        }
+    }
+    if (from[t] == -1) return true;                 // plus de chemin augmentant
+
+    long long pathFlow = std::numeric_limits<long long>::max();
+    for (int v = t; v != s; v = head[via[v] ^ 1]) pathFlow = std::min(pathFlow, residual[via[v]]);
+    for (int v = t; v != s; v = head[via[v] ^ 1]) {
+        residual[via[v]]     -= pathFlow;
+        residual[via[v] ^ 1] += pathFlow;
+    }
+    total += pathFlow;
+    return false;
+}
+
+/*======================================================================
+   ShortestPathTask
+======================================================================*/
+ShortestPathTask::ShortestPathTask(std::shared_ptr<const GraphSnapshot> snapshot, int source, int sink)
+    : keep(snapshot), graph(*keep) { init(source, sink); }
+
+ShortestPathTask::ShortestPathTask(const GraphSnapshot& snapshot, int source, int sink)
+    : graph(snapshot) { init(source, sink); }
+
+void ShortestPathTask::init(int source, int sink) {
+    s = graph.indexOf(source);
+    t = graph.indexOf(sink);
+    if (s < 0 || t < 0) return;
+    if (!graph.connected(s, t)) { t = -1; return; } // autre composante : aucun chemin
+    dist.assign(graph.nodeCount(), std::numeric_limits<float>::infinity());
+    parent.assign(graph.nodeCount(), -1);
+    dist[s] = 0.0f;
+    heap.push_back(PQItem(0.0f, s));
+}
+
+bool ShortestPathTask::step() {
+    const std::greater<PQItem> later;
+    for (int k = 0; k < SETTLE_PER_STEP; ++k) {
+        if (heap.empty()) return true;
+        std::pop_heap(heap.begin(), heap.end(), later);
+        PQItem top = heap.back();
+        heap.pop_back();
+        int u = top.second;
+        if (top.first != dist[u]) continue;         // entrée périmée
+        ++settledCount;
+        if (u == t) return true;                    // arrivé
+        for (int e = graph.edgeBegin(u); e < graph.edgeEnd(u); ++e) {
+            if (std::isinf(graph.weight(e))) continue;   // tuyau en réparation
+            int v = graph.target(e);
+            float nd = top.first + graph.weight(e);
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                parent[v] = u;
+                heap.push_back(PQItem(nd, v));
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+    }
+    return false;
+}
+
+float ShortestPathTask::distance() const {
+    if (s < 0 || t < 0) return std::numeric_limits<float>::infinity();
+    return dist[t];
+}
+
+std::vector<int> ShortestPathTask::path() const {
+    if (std::isinf(distance())) return {};
+    std::vector<int> nodes;
+    for (int cur = t; cur != -1; cur = parent[cur]) nodes.push_back(graph.kcId(cur));
+    std::reverse(nodes.begin(), nodes.end());
+    return nodes;
+}
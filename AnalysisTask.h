@@ -0,0 +1,108 @@
+// AnalysisTask.h
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "GraphSnapshot.h"
+
+// ---------------------------------------------------------------------
+//  Analyses interruptibles : le calcul est découpé en pas (un chemin
+//  augmentant, un lot de nœuds de Dijkstra) et l'état est conservé entre
+//  deux pas, comme une coroutine qui rend la main périodiquement.
+//
+//    resume(tranche)  avance jusqu'à épuiser la tranche de temps ;
+//    run(échéance, f) avance jusqu'à la fin, l'annulation ou l'échéance,
+//                     en appelant f(tâche) entre deux tranches ;
+//    cancel()         depuis n'importe quel thread, pris en compte au pas suivant.
+//
+//  Le résultat partiel reste lisible à tout moment (borne inférieure du
+//  débit, meilleure distance connue). Les tâches lisent une GraphSnapshot :
+//  le réseau peut être modifié et republié pendant le calcul.
+// ---------------------------------------------------------------------
+class AnalysisTask {
+public:
+    typedef std::chrono::steady_clock Clock;
+    enum class Status { Running, Done, Cancelled, DeadlineExceeded };
+    typedef std::function<void(const AnalysisTask&)> ProgressFn;
+
+private:
+    std::atomic<bool> cancelRequested;
+    Status            current = Status::Running;
+    std::size_t       stepCount = 0;
+
+protected:
+    virtual bool step() = 0;                        // un pas ; true quand terminé
+
+public:
+    AnalysisTask() : cancelRequested(false) {}
+    virtual ~AnalysisTask() {}
+
+    Status resume(Clock::duration slice);
+    Status run(Clock::time_point deadline = Clock::time_point::max(),
+               const ProgressFn& onProgress = ProgressFn(),
+               Clock::duration every = std::chrono::milliseconds(100));
+
+    void        cancel()         { cancelRequested = true; }
+    Status      status() const   { return current; }
+    bool        finished() const { return current != Status::Running; }
+    std::size_t steps() const    { return stepCount; }
+};
+
+// ----- Edmonds‑Karp : un pas = une recherche de chemin augmentant -------
+class MaxFlowTask : public AnalysisTask {
+private:
+    std::shared_ptr<const GraphSnapshot> keep;       // nullptr : version tenue par l'appelant
+    const GraphSnapshot&                 graph;
+    int                                  s, t;
+    std::vector<int>                     start, arcs, head;   // arcs résiduels (2k, 2k+1)
+    std::vector<long long>               residual;
+    std::vector<int>                     via, queue;
+    long long                            total = 0;
+
+    void init(int source, int sink);
+
+protected:
+    bool step() override;
+
+public:
+    MaxFlowTask(std::shared_ptr<const GraphSnapshot> snapshot, int source, int sink);
+    MaxFlowTask(const GraphSnapshot& snapshot, int source, int sink);
+
+    // borne inférieure tant que la tâche tourne, débit maximal une fois Done
+    long long flow() const { return total; }
+};
+
+// ----- Dijkstra : un pas = jusqu'à SETTLE_PER_STEP nœuds fixés ---------
+class ShortestPathTask : public AnalysisTask {
+public:
+    static const int SETTLE_PER_STEP = 256;
+
+private:
+    typedef std::pair<float,int> PQItem;
+
+    std::shared_ptr<const GraphSnapshot> keep;
+    const GraphSnapshot&                 graph;
+    int                                  s, t;
+    std::vector<float>                   dist;
+    std::vector<int>                     parent;
+    std::vector<PQItem>                  heap;       // tas min (std::push_heap / pop_heap)
+    std::size_t                          settledCount = 0;
+
+    void init(int source, int sink);
+
+protected:
+    bool step() override;
+
+public:
+    ShortestPathTask(std::shared_ptr<const GraphSnapshot> snapshot, int source, int sink);
+    ShortestPathTask(const GraphSnapshot& snapshot, int source, int sink);
+
+    // meilleure distance connue jusqu'au puits (+inf si aucune) : majorant
+    // tant que la tâche tourne, exacte une fois Done
+    float            distance() const;
+    std::vector<int> path() const;                   // IDs de KC, vide si aucun chemin
+    std::size_t      settled() const { return settledCount; }
+};
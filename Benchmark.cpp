@@ -0,0 +1,771 @@
+// Benchmark.cpp – mesure les chemins critiques sur des réseaux générés
+// (NetworkGenerator) à plusieurs échelles. Sortie : une ligne JSON par
+// (benchmark, échelle) avec médiane / p99 / min et pic mémoire.
+//
+//   g++ -std=c++11 -O2 -o bench Benchmark.cpp NetworkGenerator.cpp Pipe.cpp KC.cpp
+//       GasNetwork.cpp ReachabilityIndex.cpp ComponentIndex.cpp RegionPartition.cpp Logger.cpp EventLog.cpp DataFile.cpp PipeStore.cpp CompanyIndex.cpp TrigramIndex.cpp StringPool.cpp IdAllocator.cpp ScenarioOverlay.cpp GraphSnapshot.cpp AnalysisTask.cpp TaskScheduler.cpp CommandProcessor.cpp DiskGraph.cpp PagedFile.cpp -pthread
+//   bench [--scales 1000,5000] [--reps 15] [--only findShortestPath,hasCycle]
+//         [--budget-ms 3000] [--rounds N] [--full] [--threads N] [-o bench_output.txt]
+//
+// Passage à l'échelle du TaskScheduler : comparer scheduler.flowBatch à
+// scheduler.flowBatch.serial, puis relancer avec --threads 1, 2, 4, …
+//
+// Garde-fou de performance : comparer à une référence enregistrée
+//   bench --rounds 3 -o bench_baseline.jsonl              (enregistrer)
+//   bench --rounds 3 --compare bench_baseline.jsonl       (code 1 si régression)
+//         (même graine et même nombre de threads que la référence, sauf --threads)
+//         [--tolerance 0.15] [--noise-us 50] [--metric median|min]
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include "Pipe.h"
+#include "KC.h"
+#include "GasNetwork.h"
+#include "IdAllocator.h"
+#include "ScenarioOverlay.h"
+#include "GraphSnapshot.h"
+#include "RegionPartition.h"
+#include "DiskGraph.h"
+#include "CommandProcessor.h"
+#include "DataFile.h"
+#include "Logger.h"
+#include "NetworkGenerator.h"
+#include "LatencyStats.h"
+#include "RedirectWrapper.h"
+#include "PipeStore.h"
+#include "CompanyIndex.h"
+#include "TaskScheduler.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+/* ---------------------------------------------------------------------
+   Pic mémoire (Ko). Sous Linux, clear_refs remet le pic à zéro avant
+   chaque benchmark ; ailleurs on obtient le pic depuis le lancement.
+   --------------------------------------------------------------------- */
+void resetPeakMemory() {
+#if defined(__linux__)
+    std::ofstream f("/proc/self/clear_refs");
+    if (f.is_open()) f << "5";
+#endif
+}
+
+long peakMemoryKb() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return static_cast<long>(pmc.PeakWorkingSetSize / 1024);
+    return 0;
+#elif defined(__linux__)
+    std::ifstream f("/proc/self/status");
+    std::string line;
+    while (std::getline(f, line))
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::atol(line.c_str() + 6);
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+struct Options {
+    std::vector<int>         scales = { 1000, 5000 };
+    int                      reps = 15;
+    int                      rounds = 1;                        // min-of-N sur les tours
+    long long                budgetNs = 3000LL * 1000 * 1000;   // par (benchmark, échelle)
+    bool                     full = false;                      // ignorer les plafonds
+    std::vector<std::string> only;
+    std::uint64_t            seed = 42;
+};
+
+struct BenchResult {
+    std::string name;
+    int         scale = 0;
+    int         kcs = 0;
+    int         pipes = 0;
+    std::size_t connections = 0;
+    std::size_t reps = 0;
+    long long   median = 0;
+    long long   p99 = 0;
+    long long   min = 0;
+    long        peakKb = 0;
+    unsigned    threads = 1;          // référence : threads du TaskScheduler partagé
+    double      tolerance = -1.0;     // référence : tolérance propre (optionnelle)
+};
+
+// Plafond par défaut : au-delà, le coût actuel (matrice n×n du max-flow)
+// rend la mesure interminable.
+const int MAX_SCALE_MAX_FLOW   = 3000;
+
+struct Fixture {
+    int                            scale;
+    NetworkGenerator               gen;
+    std::unordered_map<int, Pipe>  pipes;
+    std::unordered_map<int, KC>    companies;
+    GasNetwork                     network;
+    bool                           networkBuilt = false;
+    std::vector<std::pair<int,int>> queries;        // (source, sink)
+
+    Fixture(int s, const GeneratorParams& p) : scale(s), gen(p), network(pipes) {
+        gen.build(pipes, companies);
+        int n = gen.companyCount();
+        for (int i = 0; i < 8 && n > 1; ++i)
+            queries.push_back(std::make_pair(1 + i % std::max(1, n / 16), n - (i * 7) % std::max(1, n / 16)));
+    }
+
+    // construction « comme l'utilisateur » : addConnection sur le registre
+    void buildNetwork(GasNetwork& net) const {
+        net.refreshPipes();                          // registre rempli après coup
+        for (const ConnectionRecord& c : gen.connections())
+            net.addConnection(c.from, c.to, c.pipe_id);
+    }
+};
+
+class Harness {
+private:
+    Options                  opt;
+    std::vector<BenchResult> results;        // min-of-N sur les tours, ordre d'apparition
+    int                      failures = 0;   // benches interrompus par une exception
+
+    bool selected(const std::string& name) const {
+        return opt.only.empty() ||
+               std::find(opt.only.begin(), opt.only.end(), name) != opt.only.end();
+    }
+
+    void record(const std::string& name, const Fixture& f, LatencyStats& s, long peakKb) {
+        std::cerr << "  " << name << " @" << f.scale << ": median "
+                  << s.median() / 1e3 << " us, p99 " << s.percentile(99) / 1e3
+                  << " us (" << s.count() << " reps)\n";
+        for (BenchResult& r : results) {
+            if (r.name != name || r.scale != f.scale) continue;
+            r.reps  += s.count();
+            r.median = std::min(r.median, s.median());
+            r.p99    = std::min(r.p99, s.percentile(99));
+            r.min    = std::min(r.min, s.min());
+            r.peakKb = std::max(r.peakKb, peakKb);
+            return;
+        }
+        BenchResult r;
+        r.name = name;
+        r.scale = f.scale;
+        r.kcs = f.gen.companyCount();
+        r.pipes = f.gen.pipeCount();
+        r.connections = f.gen.connections().size();
+        r.reps = s.count();
+        r.median = s.median();
+        r.p99 = s.percentile(99);
+        r.min = s.min();
+        r.peakKb = peakKb;
+        results.push_back(r);
+    }
+
+public:
+    explicit Harness(const Options& o) : opt(o) {}
+
+    const std::vector<BenchResult>& getResults() const { return results; }
+    int failed() const { return failures; }
+
+    bool allows(int maxScale, int scale) const {
+        return opt.full || maxScale <= 0 || scale <= maxScale;
+    }
+
+    // setup() hors chronométrage, body() chronométré. Une exception de l'un
+    // ou de l'autre est une erreur, pas un échantillon : rien n'est retenu
+    // pour ce tour et bench finit en échec.
+    template<typename Setup, typename Body>
+    void run(const std::string& name, Fixture& f, int maxScale, Setup setup, Body body) {
+        if (!selected(name)) return;
+        if (!allows(maxScale, f.scale)) {
+            std::cerr << "  " << name << " @" << f.scale << ": skipped (above "
+                      << maxScale << ", use --full)\n";
+            return;
+        }
+        LatencyStats stats;
+        long long spent = 0;
+        resetPeakMemory();
+        try {
+            for (int rep = 0; rep < opt.reps && (rep < 3 || spent < opt.budgetNs); ++rep) {
+                setup(rep);
+                auto t0 = LatencyStats::Clock::now();
+                body(rep);
+                auto t1 = LatencyStats::Clock::now();
+                stats.add(t0, t1);
+                spent += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+                if (spent > opt.budgetNs * 4) break;         // même pas 3 répétitions raisonnables
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "  " << name << " @" << f.scale << ": error: " << e.what() << '\n';
+            ++failures;
+            return;
+        }
+        record(name, f, stats, peakMemoryKb());
+    }
+
+    template<typename Body>
+    void run(const std::string& name, Fixture& f, int maxScale, Body body) {
+        run(name, f, maxScale, [](int) {}, body);
+    }
+};
+
+void writeResults(std::ostream& out, const std::vector<BenchResult>& results, std::uint64_t seed,
+                  unsigned threads) {
+    for (const BenchResult& r : results)
+        out << "{\"bench\":\"" << r.name << "\",\"scale\":" << r.scale
+            << ",\"seed\":" << seed
+            << ",\"threads\":" << threads
+            << ",\"kcs\":" << r.kcs
+            << ",\"pipes\":" << r.pipes
+            << ",\"connections\":" << r.connections
+            << ",\"reps\":" << r.reps
+            << ",\"median_ns\":" << r.median
+            << ",\"p99_ns\":" << r.p99
+            << ",\"min_ns\":" << r.min
+            << ",\"peak_rss_kb\":" << r.peakKb << "}\n";
+}
+
+/* ---------------------------------------------------------------------
+   Référence : lecture des lignes JSON produites par writeResults (format
+   plat connu, pas besoin d'un vrai parseur JSON).
+   --------------------------------------------------------------------- */
+std::string jsonField(const std::string& line, const std::string& key) {
+    std::string pattern = "\"" + key + "\":";
+    std::size_t pos = line.find(pattern);
+    if (pos == std::string::npos) return std::string();
+    pos += pattern.size();
+    if (pos < line.size() && line[pos] == '"') {
+        std::size_t end = line.find('"', pos + 1);
+        return line.substr(pos + 1, end == std::string::npos ? std::string::npos : end - pos - 1);
+    }
+    std::size_t end = line.find_first_of(",}", pos);
+    return line.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+}
+
+// Une ligne sans "threads" date d'avant le TaskScheduler : un seul thread
+bool loadBaseline(const std::string& filename, std::vector<BenchResult>& baseline,
+                  std::uint64_t& seed, unsigned& threads) {
+    std::ifstream in(filename);
+    if (!in.is_open()) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] != '{') continue;
+        BenchResult r;
+        r.name   = jsonField(line, "bench");
+        r.scale  = std::atoi(jsonField(line, "scale").c_str());
+        r.median = std::atoll(jsonField(line, "median_ns").c_str());
+        r.p99    = std::atoll(jsonField(line, "p99_ns").c_str());
+        r.min    = std::atoll(jsonField(line, "min_ns").c_str());
+        std::string tol = jsonField(line, "tolerance");
+        if (!tol.empty()) r.tolerance = std::atof(tol.c_str());
+        std::string t = jsonField(line, "threads");
+        if (!t.empty()) r.threads = static_cast<unsigned>(std::max(1, std::atoi(t.c_str())));
+        std::string s = jsonField(line, "seed");
+        if (!s.empty()) seed = std::strtoull(s.c_str(), nullptr, 10);
+        if (r.name.empty()) continue;
+        threads = r.threads;
+        baseline.push_back(r);
+    }
+    return true;
+}
+
+struct GateOptions {
+    std::string baselineFile;
+    double      tolerance = 0.15;          // +15 % toléré
+    long long   noiseNs = 50 * 1000;        // écarts absolus < 50 us ignorés
+    bool        useMin = false;             // comparer min_ns au lieu de median_ns
+};
+
+// Renvoie le nombre de régressions ; une ligne n'est comparée qu'à une
+// référence mesurée avec autant de threads (sinon : « new »)
+int compareWithBaseline(const std::vector<BenchResult>& fresh,
+                        const std::vector<BenchResult>& baseline,
+                        const GateOptions& gate, unsigned threads) {
+    int regressions = 0;
+    std::fprintf(stderr, "\n%-26s %7s %14s %14s %8s  %s\n",
+                 "benchmark", "scale", "baseline(us)", "current(us)", "delta", "status");
+    for (const BenchResult& r : fresh) {
+        const BenchResult* base = nullptr;
+        for (const BenchResult& b : baseline)
+            if (b.name == r.name && b.scale == r.scale && b.threads == threads) { base = &b; break; }
+        long long now = gate.useMin ? r.min : r.median;
+        if (!base) {
+            std::fprintf(stderr, "%-26s %7d %14s %14.1f %8s  new\n",
+                         r.name.c_str(), r.scale, "-", now / 1e3, "-");
+            continue;
+        }
+        long long ref = gate.useMin ? base->min : base->median;
+        double tol   = base->tolerance >= 0 ? base->tolerance : gate.tolerance;
+        double delta = ref > 0 ? (now - ref) / static_cast<double>(ref) : 0.0;
+        const char* status = "ok";
+        if (delta > tol && now - ref > gate.noiseNs) { status = "REGRESSION"; ++regressions; }
+        else if (delta < -tol && ref - now > gate.noiseNs) status = "faster";
+        std::fprintf(stderr, "%-26s %7d %14.1f %14.1f %+7.1f%%  %s\n",
+                     r.name.c_str(), r.scale, ref / 1e3, now / 1e3, delta * 100.0, status);
+    }
+    return regressions;
+}
+
+std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> items;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+void runScale(Harness& h, Fixture& f) {
+    const std::string tmpFile = "bench_data.tmp";
+    volatile long long sink = 0;             // empêche l'élimination des appels
+
+    /* ----------------------------- fichiers ----------------------------- */
+    h.run("saveToFile", f, 0, [&](int) {
+        if (!saveToFile(f.pipes, f.companies, tmpFile))
+            throw std::runtime_error("unable to write " + tmpFile);
+    });
+    h.run("loadFromFile", f, 0,
+        [&](int rep) {                               // son propre fichier : --only loadFromFile
+            if (rep == 0 && !saveToFile(f.pipes, f.companies, tmpFile))
+                throw std::runtime_error("unable to write " + tmpFile);
+        },
+        [&](int) {
+            std::unordered_map<int, Pipe> p;
+            std::unordered_map<int, KC>   c;
+            std::string file = tmpFile;
+            if (!loadFromFile(p, c, file)) throw std::runtime_error("unable to read " + tmpFile);
+            sink = static_cast<long long>(p.size());
+        });
+    std::remove(tmpFile.c_str());
+
+    /* ----------------------------- recherche ---------------------------- */
+    h.run("searchObjects.pipeName", f, 0, [&](int rep) {
+        std::string name = "pipe" + std::to_string(1 + (rep * 7919) % std::max(1, f.gen.pipeCount()));
+        sink = static_cast<long long>(searchObjects<Pipe>(f.pipes,
+            [&name](const Pipe& p) { return p.getName() == name; }).size());
+    });
+    h.run("searchObjects.pipeRepair", f, 0, [&](int) {
+        sink = static_cast<long long>(searchObjects<Pipe>(f.pipes,
+            [](const Pipe& p) { return p.isRepair(); }).size());
+    });
+    PipeStore store(f.pipes);
+    h.run("pipeStore.name", f, 0, [&](int rep) {
+        std::string name = "pipe" + std::to_string(1 + (rep * 7919) % std::max(1, f.gen.pipeCount()));
+        sink = static_cast<long long>(store.whereName(name).size());
+    });
+    h.run("pipeStore.repair", f, 0, [&](int) {
+        sink = static_cast<long long>(store.whereRepair(true).size());
+    });
+    h.run("pipeStore.diameter", f, 0, [&](int) {
+        sink = static_cast<long long>(store.whereDiameter(1400, 1400).size());
+    });
+    h.run("pipeStore.nameContains", f, 0, [&](int rep) {
+        std::string text = std::to_string(100 + (rep * 7919) % 900);       // 3 chiffres
+        sink = static_cast<long long>(store.whereNameContains(text).size());
+    });
+    h.run("pipeStore.combined", f, 0, [&](int) {
+        PipeStore::Query q;
+        q.repair = 0;
+        q.minDiameter = 700;
+        q.maxDiameter = 1000;
+        q.minLength = 500.0f;
+        sink = static_cast<long long>(store.select(q).size());
+    });
+    h.run("searchObjects.kcUnused", f, 0, [&](int) {
+        sink = static_cast<long long>(searchObjects<KC>(f.companies, [](const KC& c) {
+            return c.getWorkshop() > 0 &&
+                   100.0 * (c.getWorkshop() - c.getWorkshopInOperation()) / c.getWorkshop() >= 50.0;
+        }).size());
+    });
+    IdAllocator pipeIds(f.pipes);
+    h.run("idAllocator.reuse", f, 0, [&](int rep) {          // suppression puis ajout
+        pipeIds.release(1 + (rep * 7919) % std::max(1, f.gen.pipeCount()));
+        sink = pipeIds.acquire();
+    });
+    CompanyIndex companyIndex(f.companies);
+    h.run("companyIndex.name", f, 0, [&](int rep) {
+        std::string name = "KC" + std::to_string(1 + (rep * 7919) % std::max(1, f.gen.companyCount()));
+        sink = static_cast<long long>(companyIndex.whereName(name).size());
+    });
+    h.run("companyIndex.namePrefix", f, 0, [&](int rep) {
+        std::string text = "kc" + std::to_string(1 + rep % 9) + "7";
+        sink = static_cast<long long>(companyIndex.whereNamePrefix(text).size());
+    });
+    h.run("companyIndex.unused", f, 0, [&](int) {
+        sink = static_cast<long long>(companyIndex.whereUnusedAtLeast(50.0).size());
+    });
+
+    /* ----------------------------- réseau ------------------------------- */
+    h.run("addConnection.bulk", f, 0,
+        [&](int) { f.network = GasNetwork(f.pipes); },
+        [&](int) { f.buildNetwork(f.network); f.networkBuilt = true; });
+    GasNetwork imported(f.pipes);
+    h.run("addConnections.batch", f, 0,
+        [&](int) { imported = GasNetwork(f.pipes); },
+        [&](int) { sink = static_cast<long long>(imported.addConnections(f.gen.connections()).size()); });
+    std::string connectionLines;                       // mêmes arêtes en commandes --batch
+    for (const ConnectionRecord& c : f.gen.connections())
+        connectionLines += "{\"cmd\":\"add_connection\",\"from\":" + std::to_string(c.from) +
+                           ",\"to\":" + std::to_string(c.to) + ",\"pipe\":" + std::to_string(c.pipe_id) + "}\n";
+    h.run("commandProcessor.connections", f, 0,
+        [&](int) { imported = GasNetwork(f.pipes); },
+        [&](int) {
+            CommandProcessor processor(f.pipes, f.companies, store, companyIndex, imported);
+            std::istringstream in(connectionLines);
+            std::ostringstream out;
+            sink = static_cast<long long>(processor.run(in, out));
+        });
+    if (!f.networkBuilt) {
+        f.buildNetwork(f.network);                   // --only sans addConnection.bulk
+        f.networkBuilt = true;
+    }
+    f.network.publish();                             // lecteurs de GraphSnapshot, même avec --only
+
+    h.run("hasCycle", f, 0, [&](int) { sink = f.network.hasCycle(); });
+    h.run("reachability.query", f, 0, [&](int rep) {         // 1024 paires de KC
+        const int n = f.gen.companyCount();
+        long long total = 0;
+        for (int k = 0; k < 1024; ++k)
+            total += f.network.canReach(1 + (rep * 7919 + k * 104729) % n, 1 + (rep * 31 + k * 7907) % n);
+        sink = total;
+    });
+    h.run("removeConnection.readd", f, 0, [&](int rep) {     // reconstruction + ajout incrémental
+        const auto& conns = f.gen.connections();
+        if (conns.empty()) return;
+        const ConnectionRecord& c = conns[(rep * 7919) % conns.size()];
+        f.network.removeConnectionByPipe(c.pipe_id);
+        sink = f.network.addConnection(c.from, c.to, c.pipe_id);
+    });
+    h.run("topologicalSort", f, 0, [&](int) {
+        sink = static_cast<long long>(f.network.topologicalSort(f.companies).size());
+    });
+    h.run("findShortestPath", f, 0, [&](int rep) {
+        const auto& q = f.queries[rep % f.queries.size()];
+        sink = static_cast<long long>(f.network.findShortestPath(q.first, q.second, f.pipes).size());
+    });
+    {                                                  // sous-réseau isolé : deux KC de plus
+        const int n = f.gen.companyCount();
+        const int spare = f.network.availableDiameters().empty()
+                        ? -1 : f.network.firstUnusedPipe(f.network.availableDiameters().front());
+        if (spare > 0 && f.network.addConnection(n + 1, n + 2, spare)) {
+            h.run("findShortestPath.crossComponent", f, 0, [&](int rep) {
+                const auto& q = f.queries[rep % f.queries.size()];
+                sink = static_cast<long long>(f.network.findShortestPath(q.first, n + 2, f.pipes).size());
+            });
+            h.run("components.list", f, 0, [&](int) {
+                sink = static_cast<long long>(f.network.components().size());
+            });
+            f.network.removeConnectionByPipe(spare);
+        }
+    }
+    h.run("freePipe.select", f, 0, [&](int) {          // liste des diamètres + choix
+        long long total = 0;
+        for (int d : f.network.availableDiameters())
+            total += f.network.firstUnusedPipe(d) + static_cast<long long>(f.network.unusedPipeCount(d));
+        sink = total;
+    });
+    h.run("updatePipeInNetwork", f, 0, [&](int rep) {
+        const auto& conns = f.gen.connections();
+        if (conns.empty()) return;
+        int id = conns[(rep * 7919) % conns.size()].pipe_id;
+        Pipe& p = f.pipes[id];
+        for (int k = 0; k < 2; ++k) {                    // aller-retour : état inchangé
+            p.setRepair(!p.isRepair());
+            f.network.updatePipeInNetwork(id);
+        }
+    });
+    h.run("updatePipesInNetwork.batch", f, 0, [&](int rep) {   // 256 tuyaux, aller-retour
+        const auto& conns = f.gen.connections();
+        if (conns.empty()) return;
+        std::vector<int> ids;
+        for (int k = 0; k < 256; ++k) ids.push_back(conns[(rep * 7919 + k * 104729) % conns.size()].pipe_id);
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int id : ids) { Pipe& p = f.pipes[id]; p.setRepair(!p.isRepair()); }
+            f.network.updatePipesInNetwork(ids);
+        }
+    });
+    h.run("scenario.shortestPath", f, 0, [&](int rep) {      // 3 tuyaux en réparation
+        const auto& conns = f.gen.connections();
+        const auto& q = f.queries[rep % f.queries.size()];
+        ScenarioOverlay scenario;
+        for (int k = 0; k < 3 && !conns.empty(); ++k)
+            scenario.setRepair(f.pipes.at(conns[(rep * 7919 + k * 104729) % conns.size()].pipe_id), true);
+        sink = static_cast<long long>(f.network.findShortestPath(q.first, q.second, f.pipes, &scenario).size());
+    });
+    h.run("calculateMaxFlow", f, MAX_SCALE_MAX_FLOW, [&](int rep) {
+        const auto& q = f.queries[rep % f.queries.size()];
+        sink = f.network.calculateMaxFlow(q.first, q.second);
+    });
+    h.run("snapshot.publish", f, 0, [&](int rep) {          // 1 tuyau modifié : capacités seules
+        const auto& conns = f.gen.connections();
+        if (conns.empty()) return;
+        int id = conns[(rep * 7919) % conns.size()].pipe_id;
+        Pipe& p = f.pipes[id];
+        for (int k = 0; k < 2; ++k) {                    // aller-retour : état inchangé
+            p.setRepair(!p.isRepair());
+            f.network.updatePipeInNetwork(id);
+            f.network.publish();
+        }
+    });
+    h.run("snapshot.maxFlow", f, 0, [&](int rep) {
+        const auto& q = f.queries[rep % f.queries.size()];
+        std::shared_ptr<const GraphSnapshot> snap = f.network.snapshot();
+        sink = snap ? snap->calculateMaxFlow(q.first, q.second) : 0;
+    });
+    h.run("snapshot.levels", f, 0, [&](int) {               // niveaux recalculés à chaque fois
+        std::shared_ptr<const GraphSnapshot> snap = f.network.snapshot();
+        if (!snap) return;
+        GraphSnapshot::Levels levels;
+        GraphSnapshot::computeLevels(static_cast<int>(snap->nodeCount()), snap->topology()->offsets,
+                                     snap->topology()->targets, levels);
+        sink = static_cast<long long>(levels.levelCount());
+    });
+    h.run("snapshot.distancesFrom", f, 0, [&](int rep) {
+        const auto& q = f.queries[rep % f.queries.size()];
+        std::shared_ptr<const GraphSnapshot> snap = f.network.snapshot();
+        sink = snap ? static_cast<long long>(snap->distancesFrom(q.first).size()) : 0;
+    });
+    h.run("snapshot.widestFrom", f, 0, [&](int rep) {
+        const auto& q = f.queries[rep % f.queries.size()];
+        std::shared_ptr<const GraphSnapshot> snap = f.network.snapshot();
+        sink = snap ? static_cast<long long>(snap->widestFrom(q.first).size()) : 0;
+    });
+
+    /* ----------------------------- régions ------------------------------ */
+    // même taille, en régions d'environ 500 KC reliées par 4 interconnexions ;
+    // requêtes d'une région vers la suivante, sans puis avec découpage
+    {
+        GeneratorParams rp = f.gen.parameters();
+        rp.regions = std::max(2, f.scale / 500);
+        rp.interconnects = 4;
+        NetworkGenerator regional(rp);
+        std::unordered_map<int, Pipe> rPipes;
+        std::unordered_map<int, KC>   rCompanies;
+        regional.build(rPipes, rCompanies);
+        GasNetwork whole(rPipes), split(rPipes);
+        whole.addConnections(regional.connections());
+        split.addConnections(regional.connections());
+        split.setRegions(regional.regionMap());
+        split.publish();
+
+        // début d'une région → fin de la suivante, paires reliées seulement
+        const int step = regional.companyCount() / rp.regions;
+        std::vector<std::pair<int,int>> pairs;
+        for (int k = 0; k < 4096 && pairs.size() < 8; ++k) {
+            int r = (k * 7) % (rp.regions - 1);
+            int a = 1 + r * step + k % 16, b = (r + 2) * step - (k * 13) % 16;
+            if (whole.canReach(a, b)) pairs.push_back(std::make_pair(a, b));
+        }
+        if (pairs.empty()) pairs.push_back(std::make_pair(1, step + 1));
+        auto query = [&](int rep) { return pairs[rep % pairs.size()]; };
+        h.run("regions.partition", f, 0, [&](int) {
+            RegionPartition built(split.snapshot(), regional.regionMap());
+            sink = static_cast<long long>(built.boundaryCount());
+        });
+        h.run("regions.findShortestPath", f, 0, [&](int rep) {
+            std::pair<int,int> q = query(rep);
+            sink = static_cast<long long>(whole.findShortestPath(q.first, q.second, rPipes).size());
+        });
+        h.run("regions.findShortestPath.stitched", f, 0, [&](int rep) {
+            std::pair<int,int> q = query(rep);
+            sink = static_cast<long long>(split.findShortestPath(q.first, q.second, rPipes).size());
+        });
+        h.run("regions.maxFlow", f, 0, [&](int rep) {            // CSR, tout le réseau
+            std::pair<int,int> q = query(rep);
+            sink = split.snapshot()->calculateMaxFlow(q.first, q.second);
+        });
+        h.run("regions.maxFlow.stitched", f, 0, [&](int rep) {
+            std::pair<int,int> q = query(rep);
+            sink = split.calculateMaxFlow(q.first, q.second);
+        });
+    }
+
+    /* ------------------------- réseau sur disque ------------------------- */
+    // même réseau écrit au format DiskGraph, relu avec un cache de 4 blocs
+    // (4 Mo) : coût des parcours quand les arêtes ne sont pas en mémoire
+    {
+        const std::string diskFile = "bench_disk_" + std::to_string(f.scale) + ".graph";
+        h.run("disk.write", f, 0, [&](int) {
+            sink = f.gen.writeDiskGraph(diskFile) ? 1 : 0;
+        });
+        DiskGraph disk;
+        if (f.gen.writeDiskGraph(diskFile) && disk.open(diskFile, 4)) {
+            h.run("disk.bfs", f, 0, [&](int rep) {
+                const auto& q = f.queries[rep % f.queries.size()];
+                sink = static_cast<long long>(disk.bfsLevels(q.first).size());
+            });
+            h.run("disk.findShortestPath", f, 0, [&](int rep) {
+                const auto& q = f.queries[rep % f.queries.size()];
+                sink = static_cast<long long>(disk.findShortestPath(q.first, q.second).size());
+            });
+            h.run("disk.topologicalSort", f, 0, [&](int) {
+                sink = static_cast<long long>(disk.topologicalSort().size());
+            });
+            disk.close();
+        }
+        std::remove(diskFile.c_str());
+    }
+
+    // TaskScheduler : lot de requêtes indépendantes (grain 1) et découpage
+    // fin d'un parcours des KC (coût du vol et du fork / join)
+    const std::size_t FLOW_BATCH = 16;
+    std::vector<long long> flows(FLOW_BATCH);
+    h.run("scheduler.flowBatch", f, 0, [&](int) {
+        std::shared_ptr<const GraphSnapshot> snap = f.network.snapshot();
+        if (!snap) return;
+        TaskScheduler::shared().parallelFor(0, FLOW_BATCH, 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                const auto& q = f.queries[i % f.queries.size()];
+                flows[i] = snap->calculateMaxFlow(q.first, q.second);
+            }
+        });
+        sink = flows[0];
+    });
+    h.run("scheduler.flowBatch.serial", f, 0, [&](int) {
+        std::shared_ptr<const GraphSnapshot> snap = f.network.snapshot();
+        if (!snap) return;
+        for (std::size_t i = 0; i < FLOW_BATCH; ++i) {
+            const auto& q = f.queries[i % f.queries.size()];
+            flows[i] = snap->calculateMaxFlow(q.first, q.second);
+        }
+        sink = flows[0];
+    });
+    h.run("scheduler.nodeScan", f, 0, [&](int) {            // capacité sortante par KC
+        std::shared_ptr<const GraphSnapshot> snap = f.network.snapshot();
+        if (!snap) return;
+        std::vector<long long> outgoing(snap->nodeCount());
+        TaskScheduler::shared().parallelFor(0, snap->nodeCount(), 64, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) {
+                long long c = 0;
+                for (int e = snap->edgeBegin(static_cast<int>(i)); e < snap->edgeEnd(static_cast<int>(i)); ++e)
+                    c += snap->capacity(e);
+                outgoing[i] = c;
+            }
+        });
+        sink = outgoing.empty() ? 0 : outgoing.back();
+    });
+    (void)sink;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    GateOptions gate;
+    std::string outFile;
+    unsigned threads = 0;                            // 0 : défaut du TaskScheduler
+    GeneratorParams params;
+    params.topology = GeneratorParams::Topology::Mesh;
+    params.fanIn = 2;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--full") { opt.full = true; continue; }
+        if (i + 1 >= argc) {
+            std::cerr << "Usage: bench [--scales N,N] [--reps N] [--rounds N] [--budget-ms MS]\n"
+                         "             [--only a,b] [--seed N] [--full] [--threads N] [-o file]\n"
+                         "             [--compare baseline] [--tolerance F] [--noise-us N]\n"
+                         "             [--metric median|min]\n";
+            return 2;
+        }
+        std::string val = argv[++i];
+        if (arg == "--scales") {
+            opt.scales.clear();
+            for (const std::string& s : splitList(val)) opt.scales.push_back(std::atoi(s.c_str()));
+        }
+        else if (arg == "--reps")      opt.reps = std::max(1, std::atoi(val.c_str()));
+        else if (arg == "--rounds")    opt.rounds = std::max(1, std::atoi(val.c_str()));
+        else if (arg == "--budget-ms") opt.budgetNs = std::atoll(val.c_str()) * 1000 * 1000;
+        else if (arg == "--only")      opt.only = splitList(val);
+        else if (arg == "--seed")      opt.seed = std::strtoull(val.c_str(), nullptr, 10);
+        else if (arg == "--threads")   threads = static_cast<unsigned>(std::max(1, std::atoi(val.c_str())));
+        else if (arg == "-o")          outFile = val;
+        else if (arg == "--compare")   gate.baselineFile = val;
+        else if (arg == "--tolerance") gate.tolerance = std::atof(val.c_str());
+        else if (arg == "--noise-us")  gate.noiseNs = std::atoll(val.c_str()) * 1000;
+        else if (arg == "--metric" && (val == "median" || val == "min")) gate.useMin = val == "min";
+        else {
+            std::cerr << "Unknown option " << arg << '\n';
+            return 2;
+        }
+    }
+
+    std::vector<BenchResult> baseline;
+    if (!gate.baselineFile.empty()) {
+        std::uint64_t baselineSeed = opt.seed;
+        unsigned baselineThreads = 1;
+        if (!loadBaseline(gate.baselineFile, baseline, baselineSeed, baselineThreads)) {
+            std::cerr << "Unable to read baseline " << gate.baselineFile << '\n';
+            return 2;
+        }
+        if (baselineSeed != opt.seed) {
+            std::cerr << "Using baseline seed " << baselineSeed << '\n';
+            opt.seed = baselineSeed;                 // mêmes réseaux que la référence
+        }
+        if (threads == 0) {
+            if (baselineThreads != std::max(1u, std::thread::hardware_concurrency()))
+                std::cerr << "Using baseline thread count " << baselineThreads << '\n';
+            threads = baselineThreads;               // benches parallèles comparables
+        } else if (threads != baselineThreads) {
+            std::cerr << "Warning: baseline measured with " << baselineThreads << " thread(s), running with "
+                      << threads << " : rows are not compared\n";
+        }
+    }
+    params.seed = opt.seed;
+    if (threads > 0) TaskScheduler::setSharedThreadCount(threads);
+
+    std::ofstream file;
+    if (!outFile.empty()) {
+        file.open(outFile);
+        if (!file.is_open()) {
+            std::cerr << "Unable to open " << outFile << '\n';
+            return 1;
+        }
+    }
+
+    // Les fonctions mesurées écrivent sur std::cout et dans le journal :
+    // on coupe les deux ; les résultats passent par une copie du tampon d'origine.
+    std::ostream realOut(std::cout.rdbuf());
+    Logger::setMuted(true);
+    null_output_buffer nullBuf;
+    std::ostream nullOut(&nullBuf);
+    redirect_output_wrapper quiet(std::cout);
+    quiet.redirect(nullOut);
+
+    Harness h(opt);
+    for (int scale : opt.scales) {
+        params.companies = scale;
+        Fixture f(scale, params);
+        for (int round = 0; round < opt.rounds; ++round) {
+            std::cerr << "scale " << scale << " (round " << round + 1 << "/" << opt.rounds << ")\n";
+            runScale(h, f);
+        }
+    }
+
+    writeResults(outFile.empty() ? realOut : static_cast<std::ostream&>(file),
+                 h.getResults(), opt.seed, TaskScheduler::shared().threadCount());
+    if (h.failed() > 0) std::cerr << h.failed() << " benchmark run(s) failed.\n";
+    if (baseline.empty()) return h.failed() > 0 ? 1 : 0;
+
+    int regressions = compareWithBaseline(h.getResults(), baseline, gate,
+                                          TaskScheduler::shared().threadCount());
+    if (regressions > 0) {
+        std::cerr << regressions << " benchmark(s) slower than " << gate.baselineFile
+                  << " by more than the tolerance.\n";
+        return 1;
+    }
+    std::cerr << "No performance regression against " << gate.baselineFile << ".\n";
+    return h.failed() > 0 ? 1 : 0;
+}
@@ -0,0 +1,542 @@
+#include "CommandProcessor.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include "AnalysisTask.h"
+#include "DataFile.h"
+#include "DiskGraph.h"
+#include "GraphSnapshot.h"
+
+namespace {
+
+/*======================================================================
+   LECTURE – objet JSON plat (clés → chaîne / nombre / booléen)
+======================================================================*/
+struct Field {
+    std::string key;
+    std::string text;          // chaîne décodée
+    double      number = 0.0;
+    enum Kind { String, Number, Bool, Null } kind = Null;
+};
+
+class Command {
+    std::vector<Field> fields;
+
+public:
+    const Field* find(const char* key) const {
+        for (const Field& f : fields) if (f.key == key) return &f;
+        return nullptr;
+    }
+    bool text(const char* key, std::string& out) const {
+        const Field* f = find(key);
+        if (!f || f->kind != Field::String) return false;
+        out = f->text;
+        return true;
+    }
+    bool number(const char* key, double& out) const {
+        const Field* f = find(key);
+        if (!f || f->kind != Field::Number) return false;
+        out = f->number;
+        return true;
+    }
+    bool integer(const char* key, int& out) const {
+        double d;
+        if (!number(key, d) || d < INT_MIN || d > INT_MAX ||
+            d != static_cast<double>(static_cast<int>(d))) return false;
+        out = static_cast<int>(d);
+        return true;
+    }
+    bool flag(const char* key, bool& out) const {
+        const Field* f = find(key);
+        if (!f || f->kind != Field::Bool) return false;
+        out = f->number != 0.0;
+        return true;
+    }
+
+    bool parse(const std::string& line);
+};
+
+inline void skipSpaces(const char*& p) {
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') ++p;
+}
+
+// p sur le guillemet ouvrant ; \uXXXX limité au BMP (encodé en UTF-8)
+bool parseString(const char*& p, std::string& out) {
+    out.clear();
+    ++p;
+    while (*p && *p != '"') {
+        if (*p != '\\') { out += *p++; continue; }
+        ++p;
+        switch (*p) {
+            case '"': case '\\': case '/': out += *p; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                unsigned cp = 0;
+                for (int k = 1; k <= 4; ++k) {
+                    char c = p[k];
+                    cp <<= 4;
+                    if (c >= '0' && c <= '9')      cp |= c - '0';
+                    else if (c >= 'a' && c <= 'f') cp |= c - 'a' + 10;
+                    else if (c >= 'A' && c <= 'F') cp |= c - 'A' + 10;
+                    else return false;
+                }
+                p += 4;
+                if (cp < 0x80) out += static_cast<char>(cp);
+                else if (cp < 0x800) {
+                    out += static_cast<char>(0xC0 | (cp >> 6));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                } else {
+                    out += static_cast<char>(0xE0 | (cp >> 12));
+                    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                    out += static_cast<char>(0x80 | (cp & 0x3F));
+                }
+                break;
+            }
+            default: return false;
+        }
+        ++p;
+    }
+    if (*p != '"') return false;
+    ++p;
+    return true;
+}
+
+bool Command::parse(const std::string& line) {
+    fields.clear();
+    const char* p = line.c_str();
+    skipSpaces(p);
+    if (*p++ != '{') return false;
+    skipSpaces(p);
+    if (*p == '}') return true;
+    while (true) {
+        skipSpaces(p);
+        Field f;
+        if (*p != '"' || !parseString(p, f.key)) return false;
+        skipSpaces(p);
+        if (*p++ != ':') return false;
+        skipSpaces(p);
+        if (*p == '"') {
+            if (!parseString(p, f.text)) return false;
+            f.kind = Field::String;
+        } else if (std::strncmp(p, "true", 4) == 0)  { f.kind = Field::Bool; f.number = 1; p += 4; }
+        else if (std::strncmp(p, "false", 5) == 0)   { f.kind = Field::Bool; f.number = 0; p += 5; }
+        else if (std::strncmp(p, "null", 4) == 0)    { f.kind = Field::Null; p += 4; }
+        else {
+            char* end;
+            f.number = std::strtod(p, &end);
+            if (end == p) return false;
+            f.kind = Field::Number;
+            p = end;
+        }
+        fields.push_back(f);
+        skipSpaces(p);
+        if (*p == ',') { ++p; continue; }
+        if (*p != '}') return false;
+        ++p;
+        skipSpaces(p);
+        return *p == '\0';
+    }
+}
+
+/*======================================================================
+   ÉCRITURE – réponses
+======================================================================*/
+void appendError(std::string& out, const char* message) {
+    out += "{\"ok\":false,\"error\":\"";
+    out += message;
+    out += "\"}\n";
+}
+
+// message d'une exception levée par une commande (texte fixe : rien à échapper)
+const char* errorOf(const std::exception& e) {
+    if (dynamic_cast<const std::bad_alloc*>(&e))    return "out of memory";
+    if (dynamic_cast<const std::length_error*>(&e)) return "capacity exceeded";
+    return "internal error";
+}
+
+void appendOkIds(std::string& out, const std::vector<int>& ids) {
+    out += "{\"ok\":true,\"ids\":[";
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (i) out += ',';
+        out += std::to_string(ids[i]);
+    }
+    out += "]}\n";
+}
+
+void appendOkId(std::string& out, int id) {
+    out += "{\"ok\":true,\"id\":";
+    out += std::to_string(id);
+    out += "}\n";
+}
+
+}
+
+/*======================================================================
+   CommandProcessor
+======================================================================*/
+CommandProcessor::CommandProcessor(std::unordered_map<int, Pipe>& pipes_,
+                                   std::unordered_map<int, KC>& companies_,
+                                   PipeStore& pipeStore_, CompanyIndex& companyIndex_,
+                                   GasNetwork& network_)
+    : pipes(pipes_), companies(companies_), pipeStore(pipeStore_),
+      companyIndex(companyIndex_), network(network_) {}
+
+/*======================================================================
+   ANALYSES – sur une version figée, depuis n'importe quel thread
+======================================================================*/
+std::string CommandProcessor::commandOf(const std::string& line) {
+    Command c;
+    std::string cmd;
+    if (c.parse(line)) c.text("cmd", cmd);
+    return cmd;
+}
+
+bool CommandProcessor::isCommand(const std::string& cmd) {
+    static const char* const names[] = {
+        "add_pipe", "add_kc", "add_connection", "set_repair", "shortest_path", "max_flow",
+        "reachable", "search_pipes", "search_kc", "save", "load"
+    };
+    for (const char* name : names)
+        if (cmd == name) return true;
+    return false;
+}
+
+bool CommandProcessor::isQuery(const std::string& line) {
+    std::string cmd = commandOf(line);
+    return cmd == "shortest_path" || cmd == "max_flow";
+}
+
+bool CommandProcessor::answerQuery(const GraphSnapshot& snapshot, const std::string& line,
+                                   std::string& out) {
+    Command c;
+    std::string cmd;
+    int from, to;
+    if (!c.parse(line) || !c.text("cmd", cmd) || (cmd != "shortest_path" && cmd != "max_flow")) {
+        appendError(out, "not a query");
+        return false;
+    }
+    if (!c.integer("from", from) || !c.integer("to", to)) {
+        appendError(out, "query needs from, to");
+        return false;
+    }
+    if (snapshot.indexOf(from) < 0 || snapshot.indexOf(to) < 0) {
+        appendError(out, "source or sink not present in the network");
+        return false;
+    }
+    // budget_ms (optionnel) : échéance ; max_flow rend alors la borne atteinte
+    double budget = 0.0;
+    AnalysisTask::Clock::time_point deadline = AnalysisTask::Clock::time_point::max();
+    if (c.number("budget_ms", budget) && budget > 0)
+        deadline = AnalysisTask::Clock::now() +
+                   std::chrono::duration_cast<AnalysisTask::Clock::duration>(
+                       std::chrono::duration<double, std::milli>(budget));
+
+    if (cmd == "max_flow") {
+        MaxFlowTask task(snapshot, from, to);
+        bool complete = task.run(deadline) == AnalysisTask::Status::Done;
+        out += "{\"ok\":true,\"flow\":";
+        out += std::to_string(task.flow());
+        out += complete ? "}\n" : ",\"complete\":false}\n";
+        return true;
+    }
+    ShortestPathTask task(snapshot, from, to);
+    if (task.run(deadline) != AnalysisTask::Status::Done) {
+        appendError(out, "deadline exceeded");
+        return false;
+    }
+    std::vector<int> path = task.path();
+    if (path.empty()) {
+        appendError(out, "no path");
+        return false;
+    }
+    out += "{\"ok\":true,\"path\":[";
+    for (std::size_t i = 0; i < path.size(); ++i) {
+        if (i) out += ',';
+        out += std::to_string(path[i]);
+    }
+    out += "]}\n";
+    return true;
+}
+
+/*======================================================================
+   RÉSEAU SUR DISQUE – requêtes en flux sur un DiskGraph
+======================================================================*/
+bool CommandProcessor::answerDiskQuery(DiskGraph& graph, const std::string& line,
+                                       std::string& out) {
+    Command c;
+    std::string cmd;
+    if (!c.parse(line)) { appendError(out, "invalid JSON"); return false; }
+    if (!c.text("cmd", cmd)) { appendError(out, "missing cmd"); return false; }
+
+    if (cmd == "topological_sort") {
+        std::vector<int> order = graph.topologicalSort();
+        if (order.empty() && graph.nodeCount() > 0) { appendError(out, "network has a cycle"); return false; }
+        appendOkIds(out, order);
+        return true;
+    }
+    if (cmd != "shortest_path" && cmd != "bfs") {
+        appendError(out, "unknown cmd");
+        return false;
+    }
+    int from, to = 0;
+    bool hasTo = c.find("to") != nullptr;
+    if (!c.integer("from", from) || (hasTo && !c.integer("to", to)) ||
+        (cmd == "shortest_path" && !hasTo)) {
+        appendError(out, cmd == "bfs" ? "bfs needs from" : "query needs from, to");
+        return false;
+    }
+    if (graph.indexOf(from) < 0 || (hasTo && graph.indexOf(to) < 0)) {
+        appendError(out, "source or sink not present in the network");
+        return false;
+    }
+
+    if (cmd == "shortest_path") {
+        std::vector<int> path = graph.findShortestPath(from, to);
+        if (path.empty()) { appendError(out, "no path"); return false; }
+        out += "{\"ok\":true,\"path\":[";
+        for (std::size_t i = 0; i < path.size(); ++i) {
+            if (i) out += ',';
+            out += std::to_string(path[i]);
+        }
+        out += "]}\n";
+        return true;
+    }
+    std::vector<int> levels = graph.bfsLevels(from);
+    std::size_t reached = 0;
+    int depth = 0;
+    for (int h : levels)
+        if (h >= 0) { ++reached; depth = std::max(depth, h); }
+    out += "{\"ok\":true,\"reached\":";
+    out += std::to_string(reached);
+    out += ",\"depth\":";
+    out += std::to_string(depth);
+    if (hasTo) {
+        out += ",\"hops\":";
+        out += std::to_string(levels[graph.indexOf(to)]);
+    }
+    out += "}\n";
+    return true;
+}
+
+/*======================================================================
+   CONNEXIONS EN ATTENTE – doublons et cycles tranchés par addConnections
+======================================================================*/
+void CommandProcessor::flushConnections(std::string& out) {
+    if (pending.empty()) return;
+    std::vector<ConnectionRecord> batch;
+    std::vector<std::size_t>      slot;              // indice du lot → indice en attente
+    for (std::size_t i = 0; i < pending.size(); ++i)
+        if (!pending[i].error) { batch.push_back(pending[i].record); slot.push_back(i); }
+
+    std::vector<GasNetwork::RejectedConnection> rejected;
+    try {
+        rejected = network.addConnections(batch);
+    } catch (const std::exception& e) {                // lot entier en erreur
+        for (std::size_t i : slot) pending[i].error = errorOf(e);
+    }
+    for (const GasNetwork::RejectedConnection& r : rejected)
+        pending[slot[r.index]].error =
+            r.reason == GasNetwork::RejectReason::Duplicate   ? "connection already exists" :
+            r.reason == GasNetwork::RejectReason::UnknownPipe ? "unknown pipe"
+                                                              : "connection would create a cycle";
+    for (const PendingConnection& p : pending) {
+        if (!p.error) { out += "{\"ok\":true}\n"; continue; }
+        appendError(out, p.error);
+        ++failures;
+    }
+    pending.clear();
+    pendingPipes.clear();
+}
+
+/*======================================================================
+   EXÉCUTION
+======================================================================*/
+void CommandProcessor::execute(const std::string& line, std::string& out) {
+    dispatch(line, out);
+    flushConnections(out);
+}
+
+void CommandProcessor::dispatch(const std::string& line, std::string& out) {
+    auto fail = [this, &out](const char* message) { appendError(out, message); ++failures; };
+    Command c;
+    std::string cmd;
+    bool parsed = false;
+    const char* parseError = "invalid JSON";
+    try {
+        parsed = c.parse(line);
+        if (parsed) c.text("cmd", cmd);
+    } catch (const std::exception& e) {
+        parseError = errorOf(e);
+    }
+    if (cmd != "add_connection") flushConnections(out);   // réponses dans l'ordre
+
+    // Une exception (StringPool plein, mémoire…) ne coupe ni le lot ni le
+    // serveur : la commande répond {"ok":false} et la suivante est lue
+    const std::size_t mark = out.size();
+    try {
+        if (!parsed)             fail(parseError);
+        else if (cmd.empty())    fail("missing cmd");
+        else if (cmd == "add_pipe") {
+            std::string name;
+            double length;
+            int diameter;
+            bool repair = false;
+            c.flag("repair", repair);
+            if (!c.text("name", name) || !c.number("length", length) || !c.integer("diameter", diameter))
+                fail("add_pipe needs name, length, diameter");
+            else if (length <= 0 || diameter <= 0)
+                fail("length and diameter must be positive");
+            else {
+                int id = addPipe(pipes, pipeStore.allocator(), name, static_cast<float>(length), diameter, repair);
+                pipeStore.upsert(pipes[id]);
+                network.updatePipeInNetwork(id);
+                appendOkId(out, id);
+            }
+        }
+        else if (cmd == "add_kc") {
+            std::string name, classes;
+            int workshops, working;
+            c.text("classes", classes);
+            if (!c.text("name", name) || !c.integer("workshops", workshops) || !c.integer("working", working))
+                fail("add_kc needs name, workshops, working");
+            else if (workshops <= 0 || working < 0 || working > workshops)
+                fail("invalid workshop counts");
+            else {
+                int id = addCompany(companies, companyIndex.allocator(), name, workshops, working, classes);
+                companyIndex.upsert(companies[id]);
+                appendOkId(out, id);
+            }
+        }
+        else if (cmd == "add_connection") {
+            PendingConnection p;
+            p.error = nullptr;
+            int from, to, pipe;
+            if (!c.integer("from", from) || !c.integer("to", to) || !c.integer("pipe", pipe))
+                p.error = "add_connection needs from, to, pipe";
+            else {
+                p.record = ConnectionRecord{from, to, pipe};
+                if (pendingPipes.count(pipe)) flushConnections(out);   // dépend du lot en attente
+                if (!companies.count(from) || !companies.count(to)) p.error = "unknown KC";
+                else if (from == to)                                p.error = "from and to are identical";
+                else if (!pipes.count(pipe))                        p.error = "unknown pipe";
+                else if (network.isPipeUsed(pipe))                  p.error = "pipe already in use";
+                else pendingPipes.insert(pipe);
+            }
+            pending.push_back(p);
+            return;                                        // réponse au flushConnections
+        }
+        else if (cmd == "set_repair") {
+            int id;
+            bool repair;
+            auto it = pipes.end();
+            if (!c.integer("id", id) || !c.flag("repair", repair)) fail("set_repair needs id, repair");
+            else if ((it = pipes.find(id)) == pipes.end())         fail("unknown pipe");
+            else {
+                it->second.setRepair(repair);
+                pipeStore.upsert(it->second);
+                network.updatePipeInNetwork(id);
+                out += "{\"ok\":true}\n";
+            }
+        }
+        else if (cmd == "shortest_path" || cmd == "max_flow") {
+            network.publish();                             // sans effet si rien n'a changé
+            if (!answerQuery(*network.snapshot(), line, out)) ++failures;
+        }
+        else if (cmd == "reachable") {                     // index du réseau vivant, sans parcours
+            int from, to;
+            if (!c.integer("from", from) || !c.integer("to", to)) fail("reachable needs from, to");
+            else {
+                out += "{\"ok\":true,\"reachable\":";
+                out += network.canReach(from, to) ? "true}\n" : "false}\n";
+            }
+        }
+        else if (cmd == "search_pipes") {
+            PipeStore::Query q;
+            bool repair;
+            double length;
+            std::string contains;
+            if (c.flag("repair", repair)) q.repair = repair ? 1 : 0;
+            c.integer("min_diameter", q.minDiameter);
+            c.integer("max_diameter", q.maxDiameter);
+            if (c.number("min_length", length)) q.minLength = static_cast<float>(length);
+            if (c.number("max_length", length)) q.maxLength = static_cast<float>(length);
+            q.matchName = c.text("name", q.name);
+            std::vector<int> ids = pipeStore.select(q);
+            if (c.text("contains", contains)) {            // sous-chaîne du nom (trigrammes)
+                std::vector<int> named = pipeStore.whereNameContains(contains), both;
+                std::set_intersection(ids.begin(), ids.end(), named.begin(), named.end(),
+                                      std::back_inserter(both));
+                ids.swap(both);
+            }
+            appendOkIds(out, ids);
+        }
+        else if (cmd == "search_kc") {
+            std::string text;
+            double percent;
+            if (c.text("name", text))                appendOkIds(out, companyIndex.whereName(text));
+            else if (c.text("prefix", text))         appendOkIds(out, companyIndex.whereNamePrefix(text));
+            else if (c.text("contains", text))       appendOkIds(out, companyIndex.whereNameContains(text));
+            else if (c.number("min_unused", percent)) appendOkIds(out, companyIndex.whereUnusedAtLeast(percent));
+            else fail("search_kc needs name, prefix, contains or min_unused");
+        }
+        else if (cmd == "save") {
+            std::string file;
+            if (!c.text("file", file))                    fail("save needs file");
+            else if (pipes.empty() && companies.empty()) fail("nothing to save");
+            else if (!saveToFile(pipes, companies, file)) fail("unable to write file");
+            else out += "{\"ok\":true}\n";
+        }
+        else if (cmd == "load") {
+            std::string file;
+            if (!c.text("file", file)) fail("load needs file");
+            else {
+                bool loaded = loadFromFile(pipes, companies, file);
+                pipeStore.assign(pipes);                   // tables remplacées, même en cas d'échec partiel
+                network.refreshPipes();
+                companyIndex.assign(companies);
+                if (!loaded) fail("unable to load file");
+                else out += "{\"ok\":true,\"pipes\":" + std::to_string(pipes.size()) +
+                            ",\"companies\":" + std::to_string(companies.size()) + "}\n";
+            }
+        }
+        else fail("unknown cmd");
+    } catch (const std::exception& e) {
+        if (cmd == "add_connection") {                 // répondra à son tour, après les attentes
+            PendingConnection p;
+            p.record = ConnectionRecord{0, 0, 0};
+            p.error  = errorOf(e);
+            pending.push_back(p);
+        } else {
+            out.resize(mark);                          // réponse partielle éventuelle
+            fail(errorOf(e));
+        }
+    }
+}
+
+std::size_t CommandProcessor::run(std::istream& in, std::ostream& out) {
+    std::string line, buffer;
+    std::size_t count = 0;
+    buffer.reserve(1 << 16);
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        dispatch(line, buffer);
+        ++count;
+        if (buffer.size() >= (1 << 16)) { out.write(buffer.data(), buffer.size()); buffer.clear(); }
+    }
+    flushConnections(buffer);
+    out.write(buffer.data(), buffer.size());
+    out.flush();
+    return count;
+}
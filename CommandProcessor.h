@@ -0,0 +1,97 @@
+// CommandProcessor.h
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Pipe.h"
+#include "KC.h"
+#include "GasNetwork.h"
+#include "PipeStore.h"
+#include "CompanyIndex.h"
+#include "DataFile.h"          // ConnectionRecord
+
+class DiskGraph;
+class GraphSnapshot;
+// ---------------------------------------------------------------------
+//  Mode sans interface (main --batch) : une commande JSON par ligne,
+//  un résultat JSON par ligne, dans le même ordre.
+//
+//    {"cmd":"add_pipe","name":"P1","length":120,"diameter":700,"repair":false}
+//    {"cmd":"add_kc","name":"KC1","workshops":10,"working":7,"classes":"A"}
+//    {"cmd":"add_connection","from":1,"to":2,"pipe":1}
+//    {"cmd":"set_repair","id":1,"repair":true}
+//    {"cmd":"shortest_path","from":1,"to":2}
+//    {"cmd":"max_flow","from":1,"to":2}              (+ "budget_ms":50 : échéance,
+//                                                     borne partielle "complete":false)
+//    {"cmd":"reachable","from":1,"to":2}             (chemin d'arêtes, réparations comprises)
+//    {"cmd":"search_pipes","repair":false,"min_diameter":700,"contains":"nord"}
+//    {"cmd":"search_kc","prefix":"KC"}     (ou name / contains / min_unused)
+//    {"cmd":"save","file":"data.txt"}   {"cmd":"load","file":"data.txt"}
+//
+//  Réponses : {"ok":true,...} (id, ids, path, flow, reachable selon la
+//  commande) ou {"ok":false,"error":"..."}, y compris quand la commande
+//  lève une exception (mémoire, StringPool plein) : le lot continue. Les
+//  lignes vides sont ignorées.
+//
+//  Mêmes objets et mêmes règles que les menus (tuyau libre, KC distinctes,
+//  pas de cycle). Les requêtes lisent la version publiée du réseau
+//  (GraphSnapshot, republiée seulement si une commande l'a modifié) et
+//  n'affichent rien ; l'appelant coupe std::cout pour save / load.
+//
+//  Dans run(), les add_connection consécutifs sont mis en attente puis
+//  insérés d'un coup par GasNetwork::addConnections (un seul tri de Kahn
+//  au lieu d'un test de cycle par arête) ; réponses identiques à une
+//  exécution une par une.
+// ---------------------------------------------------------------------
+class CommandProcessor {
+private:
+    std::unordered_map<int, Pipe>& pipes;
+    std::unordered_map<int, KC>&   companies;
+    PipeStore&                     pipeStore;
+    CompanyIndex&                  companyIndex;
+    GasNetwork&                    network;
+    std::size_t                    failures = 0;
+
+    // add_connection en attente (run) : refus déjà connu ou arête à insérer
+    struct PendingConnection {
+        ConnectionRecord record;
+        const char*      error;        // nullptr : à soumettre à addConnections
+    };
+    std::vector<PendingConnection> pending;
+    std::unordered_set<int>        pendingPipes;
+
+    void dispatch(const std::string& line, std::string& out);   // peut différer la réponse
+    void flushConnections(std::string& out);
+
+public:
+    CommandProcessor(std::unordered_map<int, Pipe>& pipes,
+                     std::unordered_map<int, KC>& companies,
+                     PipeStore& pipeStore, CompanyIndex& companyIndex,
+                     GasNetwork& network);
+
+    // Exécute une ligne et ajoute sa réponse (terminée par '\n') à out
+    void execute(const std::string& line, std::string& out);
+
+    // Toutes les lignes de in ; réponses écrites par blocs. Renvoie le
+    // nombre de commandes exécutées.
+    std::size_t run(std::istream& in, std::ostream& out);
+
+    std::size_t failed() const { return failures; }
+
+    // shortest_path / max_flow : ne lisent qu'une GraphSnapshot, donc
+    // exécutables hors du thread écrivain (serveur). answerQuery renvoie
+    // false si la réponse est une erreur.
+    static bool isQuery(const std::string& line);
+    static std::string commandOf(const std::string& line);   // "" si illisible
+    static bool isCommand(const std::string& cmd);           // nom traité par execute
+    static bool answerQuery(const GraphSnapshot& snapshot, const std::string& line, std::string& out);
+
+    // main --disk : réseau sur disque, en lecture seule
+    //   {"cmd":"shortest_path","from":1,"to":2}   → path (Dijkstra, réparations exclues)
+    //   {"cmd":"bfs","from":1}  (+ "to")          → reached, depth (+ hops, -1 : inaccessible)
+    //   {"cmd":"topological_sort"}                → ids
+    static bool answerDiskQuery(DiskGraph& graph, const std::string& line, std::string& out);
+};
@@ -0,0 +1,148 @@
+#include "CompanyIndex.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace {
+// Trie des IDs ; pour un grand résultat, un bitmap sur [0, maxId] est
+// plus rapide qu'un std::sort (O(maxId / 64 + k))
+void sortIds(std::vector<int>& ids, int maxId) {
+    if (ids.size() < 64 || ids.size() * 16 < static_cast<std::size_t>(maxId)) {
+        std::sort(ids.begin(), ids.end());
+        return;
+    }
+    std::vector<std::uint64_t> bits(static_cast<std::size_t>(maxId) / 64 + 1, 0);
+    for (int id : ids) bits[id / 64] |= std::uint64_t(1) << (id % 64);
+    ids.clear();
+    for (std::size_t w = 0; w < bits.size(); ++w)
+        for (std::uint64_t m = bits[w]; m; m &= m - 1) {
+#if defined(__GNUC__) || defined(__clang__)
+            int bit = __builtin_ctzll(m);
+#else
+            int bit = 0;
+            while (!((m >> bit) & 1)) ++bit;
+#endif
+            ids.push_back(static_cast<int>(w * 64) + bit);
+        }
+}
+}
+
+double CompanyIndex::unusedPercent(const KC& company) {
+    return 100.0 * (company.getWorkshop() - company.getWorkshopInOperation()) / company.getWorkshop();
+}
+
+/*======================================================================
+   MAINTENANCE
+======================================================================*/
+void CompanyIndex::clear() {
+    entries.clear();
+    byName.clear();
+    byUnused.clear();
+    maxId = 0;
+    nameSearch.clear();
+    classSearch.clear();
+    idAllocator.clear();
+}
+
+void CompanyIndex::assign(const std::unordered_map<int, KC>& companies) {
+    clear();
+    entries.reserve(companies.size());
+    std::vector<std::pair<int, std::string>> names, classes;
+    names.reserve(companies.size());
+    classes.reserve(companies.size());
+    for (const auto& kv : companies) {                 // byUnused trié une seule fois
+        const KC& c = kv.second;
+        Entry e;
+        e.name   = c.getNameHandle();
+        e.ranked = c.getWorkshop() != 0;
+        e.unused = e.ranked ? unusedPercent(c) : 0.0;
+        byName[e.name].push_back(c.getId());
+        if (e.ranked) byUnused.push_back(std::make_pair(e.unused, c.getId()));
+        maxId = std::max(maxId, c.getId());
+        entries[c.getId()] = e;
+        idAllocator.reserve(c.getId());
+        names.push_back(std::make_pair(c.getId(), c.getName()));
+        classes.push_back(std::make_pair(c.getId(), c.getClasses()));
+    }
+    nameSearch.assign(names);
+    classSearch.assign(classes);
+    for (auto& kv : byName) std::sort(kv.second.begin(), kv.second.end());
+    std::sort(byUnused.begin(), byUnused.end());
+}
+
+void CompanyIndex::insert(const KC& company) {
+    Entry e;
+    e.name   = company.getNameHandle();
+    e.ranked = company.getWorkshop() != 0;
+    e.unused = e.ranked ? unusedPercent(company) : 0.0;
+
+    std::vector<int>& list = byName[e.name];
+    list.insert(std::lower_bound(list.begin(), list.end(), company.getId()), company.getId());
+    if (e.ranked) {
+        std::pair<double, int> key(e.unused, company.getId());
+        byUnused.insert(std::lower_bound(byUnused.begin(), byUnused.end(), key), key);
+    }
+    maxId = std::max(maxId, company.getId());
+    entries[company.getId()] = e;
+    idAllocator.reserve(company.getId());
+}
+
+void CompanyIndex::remove(int id) {
+    auto it = entries.find(id);
+    if (it == entries.end()) return;
+    const Entry& e = it->second;
+
+    auto named = byName.find(e.name);
+    if (named != byName.end()) {
+        std::vector<int>& list = named->second;
+        auto pos = std::lower_bound(list.begin(), list.end(), id);
+        if (pos != list.end() && *pos == id) list.erase(pos);
+        if (list.empty()) byName.erase(named);
+    }
+    if (e.ranked) {
+        auto pos = std::lower_bound(byUnused.begin(), byUnused.end(), std::make_pair(e.unused, id));
+        if (pos != byUnused.end() && pos->second == id) byUnused.erase(pos);
+    }
+    entries.erase(it);
+}
+
+// les trigrammes ne changent pas quand seul le nombre d'ateliers change
+void CompanyIndex::upsert(const KC& company) {
+    remove(company.getId());
+    insert(company);
+    nameSearch.upsert(company.getId(), company.getName());
+    classSearch.upsert(company.getId(), company.getClasses());
+}
+
+void CompanyIndex::erase(int id) {
+    remove(id);
+    nameSearch.erase(id);
+    classSearch.erase(id);
+    idAllocator.release(id);
+}
+
+/*======================================================================
+   RECHERCHES
+======================================================================*/
+std::vector<int> CompanyIndex::whereName(const std::string& name) const {
+    StringPool::Handle h;
+    if (!StringPool::find(name, h)) return std::vector<int>();
+    auto it = byName.find(h);
+    return it == byName.end() ? std::vector<int>() : it->second;
+}
+
+std::vector<int> CompanyIndex::whereUnusedAtLeast(double percent) const {
+    return whereUnusedBetween(percent, std::numeric_limits<double>::infinity());
+}
+
+std::vector<int> CompanyIndex::whereUnusedBetween(double minPercent, double maxPercent) const {
+    std::vector<int> found;
+    auto first = std::lower_bound(byUnused.begin(), byUnused.end(),
+                                  std::make_pair(minPercent, std::numeric_limits<int>::min()));
+    auto last  = std::upper_bound(first, byUnused.end(),
+                                  std::make_pair(maxPercent, std::numeric_limits<int>::max()));
+    found.reserve(last - first);
+    for (auto it = first; it != last; ++it) found.push_back(it->second);
+    sortIds(found, maxId);
+    return found;
+}
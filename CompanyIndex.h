@@ -0,0 +1,64 @@
+// CompanyIndex.h
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "IdAllocator.h"
+#include "KC.h"
+#include "TrigramIndex.h"
+
+// ---------------------------------------------------------------------
+//  Index secondaires des KC pour les filtres de manageCompanies :
+//    - hachage nom → IDs (égalité exacte) ;
+//    - vecteur trié de (% d'ateliers inutilisés, ID) pour les seuils ;
+//    - trigrammes du nom et des classes (préfixe / sous-chaîne, sans casse).
+//
+//  Le pourcentage est calculé une seule fois, à l'insertion, avec la même
+//  formule que le filtre d'origine ; les KC sans atelier n'y figurent pas.
+//  L'appelant tient l'index à jour (assign / upsert / erase) ; l'index
+//  tient lui-même l'allocateur d'IDs des KC (allocator()).
+// ---------------------------------------------------------------------
+class CompanyIndex {
+private:
+    struct Entry {
+        StringPool::Handle name;
+        double      unused;
+        bool        ranked;      // false si aucun atelier
+    };
+    std::unordered_map<int, Entry>                    entries;
+    std::unordered_map<StringPool::Handle, std::vector<int>> byName;   // IDs triés
+    std::vector<std::pair<double, int>>               byUnused;   // trié
+    int                                               maxId = 0;
+    TrigramIndex                                      nameSearch;
+    TrigramIndex                                      classSearch;
+    IdAllocator                                       idAllocator;
+
+    void insert(const KC& company);
+    void remove(int id);
+
+public:
+    CompanyIndex() {}
+    explicit CompanyIndex(const std::unordered_map<int, KC>& companies) { assign(companies); }
+
+    static double unusedPercent(const KC& company);
+
+    // ----- maintenance ---------------------------------------------------
+    void assign(const std::unordered_map<int, KC>& companies);
+    void upsert(const KC& company);
+    void erase(int id);
+    void clear();
+
+    std::size_t size() const { return entries.size(); }
+
+    // IDs occupés = entrées de l'index ; addCompany y prend le prochain ID
+    IdAllocator& allocator() { return idAllocator; }
+
+    // ----- recherches (IDs triés) ----------------------------------------
+    std::vector<int> whereName(const std::string& name) const;
+    std::vector<int> whereUnusedAtLeast(double percent) const;
+    std::vector<int> whereUnusedBetween(double minPercent, double maxPercent) const;
+    std::vector<int> whereNamePrefix(const std::string& text) const    { return nameSearch.prefix(text); }
+    std::vector<int> whereNameContains(const std::string& text) const  { return nameSearch.contains(text); }
+    std::vector<int> whereClassesContains(const std::string& text) const { return classSearch.contains(text); }
+};
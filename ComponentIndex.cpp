@@ -0,0 +1,79 @@
+#include "ComponentIndex.h"
+#include <algorithm>
+#include <utility>
+
+/*======================================================================
+   UNION-FIND
+======================================================================*/
+void ComponentIndex::clear() {
+    slotOf.clear();
+    kcOf.clear();
+    parent.clear();
+    size.clear();
+    count = 0;
+}
+
+int ComponentIndex::slot(int kc_id) {
+    auto ins = slotOf.emplace(kc_id, static_cast<int>(kcOf.size()));
+    if (ins.second) {
+        kcOf.push_back(kc_id);
+        parent.push_back(ins.first->second);
+        size.push_back(1);
+        ++count;
+    }
+    return ins.first->second;
+}
+
+int ComponentIndex::find(int x) const {
+    while (parent[x] != x) x = parent[x];
+    return x;
+}
+
+int ComponentIndex::root(int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];                 // compression par moitiés
+        x = parent[x];
+    }
+    return x;
+}
+
+void ComponentIndex::add(int kc_id) { slot(kc_id); }
+
+void ComponentIndex::unite(int a, int b) {
+    int ra = root(slot(a)), rb = root(slot(b));
+    if (ra == rb) return;
+    if (size[ra] < size[rb]) std::swap(ra, rb);
+    parent[rb] = ra;
+    size[ra] += size[rb];
+    --count;
+}
+
+bool ComponentIndex::connected(int a, int b) const {
+    auto x = slotOf.find(a), y = slotOf.find(b);
+    if (x == slotOf.end() || y == slotOf.end()) return false;
+    return find(x->second) == find(y->second);
+}
+
+/*======================================================================
+   DÉCOMPOSITION
+======================================================================*/
+std::vector<std::vector<int>> ComponentIndex::groups() const {
+    const int n = static_cast<int>(kcOf.size());
+    std::vector<int> order(n);
+    for (int x = 0; x < n; ++x) order[x] = x;
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return kcOf[a] < kcOf[b]; });
+
+    std::vector<int> groupOf(n, -1);                   // racine → composante
+    std::vector<std::vector<int>> result;
+    result.reserve(count);
+    for (int x : order) {                              // IDs croissants : tout est déjà trié
+        int r = find(x);
+        if (groupOf[r] < 0) {
+            groupOf[r] = static_cast<int>(result.size());
+            result.emplace_back();
+            result.back().reserve(size[r]);
+        }
+        result[groupOf[r]].push_back(kcOf[x]);
+    }
+    return result;
+}
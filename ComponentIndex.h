@@ -0,0 +1,46 @@
+// ComponentIndex.h
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------
+//  Composantes faiblement connexes du réseau (sens des arêtes ignoré) :
+//  union-find sur les IDs de KC, union par taille et compression de
+//  chemin par moitiés (dans unite() seulement : find() const ne fait que
+//  lire, plusieurs threads peuvent interroger l'index s'il ne change pas). Deux KC de composantes différentes (réseaux
+//  régionaux chargés ensemble, par exemple) n'ont aucun chemin entre
+//  elles, dans aucun sens : les analyses s'arrêtent sans rien construire.
+//
+//  unite() à chaque arête ajoutée. Une union ne se défait pas : après un
+//  retrait, le propriétaire reconstruit l'index (GasNetwork le fait à la
+//  première question qui suit).
+// ---------------------------------------------------------------------
+class ComponentIndex {
+private:
+    std::unordered_map<int, int> slotOf;           // ID de KC → nœud dense
+    std::vector<int>             kcOf;
+    std::vector<int>             parent;           // compressé par root()
+    std::vector<int>             size;             // taille, pour les racines
+    std::size_t                  count = 0;        // nombre de composantes
+
+    int slot(int kc_id);                           // nouveau nœud : composante à lui seul
+    int find(int x) const;                         // union par taille : O(log n)
+    int root(int x);                               // find avec compression
+
+public:
+    void clear();
+
+    void add(int kc_id);                           // KC sans arête
+    void unite(int a, int b);                      // arête a – b (KC créées au besoin)
+
+    bool contains(int kc_id) const { return slotOf.count(kc_id) != 0; }
+    bool connected(int a, int b) const;            // false si l'une est absente
+
+    std::size_t nodeCount() const      { return kcOf.size(); }
+    std::size_t componentCount() const { return count; }
+
+    // IDs de KC par composante, chacune triée, composantes rangées par
+    // plus petit ID
+    std::vector<std::vector<int>> groups() const;
+};
@@ -0,0 +1,133 @@
+#include "DataFile.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include "Logger.h"
+
+static inline void logAction(const std::string& action) { Logger::logAction(action); }
+
+// borne de reserve() : un compteur corrompu ne doit pas réserver des Go
+static const size_t MAX_RESERVE = size_t(1) << 22;
+
+/*======================================================================
+   SAVE / LOAD
+======================================================================*/
+bool saveToFile(const std::unordered_map<int, Pipe>& pipes,
+                const std::unordered_map<int, KC>& companies,
+                const std::string& filename) {
+    if (pipes.empty() && companies.empty()) {
+        std::cout << "Nothing to save: no pipes or companies in memory.\n";
+        logAction("Save aborted: nothing to save.");
+        return false;
+    }
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cout << "Unable to open file for saving.\n";
+        logAction("Failed to open file for saving: " + filename);
+        return false;
+    }
+    file << pipes.size() << std::endl;
+    for (const auto& kv : pipes) file << kv.second << std::endl;
+    file << companies.size() << std::endl;
+    for (const auto& kv : companies) file << kv.second << std::endl;
+
+    if (!file) {
+        std::cout << "Error occurred during saving.\n";
+        logAction("Error during saving: " + filename);
+        return false;
+    }
+    std::cout << "Data saved to file successfully.\n";
+    logAction("Saved data to file: " + filename);
+    return true;
+}
+
+bool loadFromFile(std::unordered_map<int, Pipe>& pipes,
+                  std::unordered_map<int, KC>& companies,
+                  std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cout << "Unable to open file for loading.\n";
+        logAction("Failed to open file for loading: " + filename);
+        return false;
+    }
+    size_t nPipes = 0, nCompanies = 0;
+    if (!(file >> nPipes)) {
+        std::cout << "File corrupted or invalid format (pipes count).\n";
+        logAction("Corrupted file (pipes count): " + filename);
+        return false;
+    }
+    pipes.clear();
+    pipes.reserve(std::min(nPipes, MAX_RESERVE));
+    for (size_t i = 0; i < nPipes; ++i) {
+        Pipe p;
+        if (!(file >> p)) {
+            std::cout << "File corrupted or invalid format (pipe data).\n";
+            logAction("Corrupted file (pipe data): " + filename);
+            return false;
+        }
+        int id = p.getId();
+        if (id <= 0 || pipes.count(id)) {
+            std::cout << "Invalid or duplicate pipe ID found: " << id << '\n';
+            logAction("Invalid/duplicate pipe ID: " + std::to_string(id));
+            return false;
+        }
+        pipes[id] = p;
+        Logger::logAction("LOAD PIPE", p.getId(), p.getName(),
+                         p.getLength(), p.getDiameter(), p.isRepair());
+    }
+    if (!(file >> nCompanies)) {
+        std::cout << "File corrupted or invalid format (companies count).\n";
+        logAction("Corrupted file (companies count): " + filename);
+        return false;
+    }
+    companies.clear();
+    companies.reserve(std::min(nCompanies, MAX_RESERVE));
+    for (size_t i = 0; i < nCompanies; ++i) {
+        KC c;
+        if (!(file >> c)) {
+            std::cout << "File corrupted or invalid format (company data).\n";
+            logAction("Corrupted file (company data): " + filename);
+            return false;
+        }
+        int id = c.getId();
+        if (id <= 0 || companies.count(id)) {
+            std::cout << "Invalid or duplicate company ID found: " << id << '\n';
+            logAction("Invalid/duplicate company ID: " + std::to_string(id));
+            return false;
+        }
+        companies[id] = c;
+        Logger::logAction("LOAD COMPANY", c.getId(), c.getName(),
+                          c.getWorkshop(), c.getWorkshopInOperation(),
+                          c.getClasses());
+    }
+    if (pipes.empty() && companies.empty()) {
+        std::cout << "Nothing loaded: file contains no pipes or companies.\n";
+        logAction("Load aborted: nothing in file.");
+        return false;
+    }
+    std::cout << "Data loaded from file successfully.\n";
+    logAction("Loaded data from file: " + filename);
+    return true;
+}
+
+/*======================================================================
+   CONNECTIONS LIST
+======================================================================*/
+bool saveConnections(const std::vector<ConnectionRecord>& connections,
+                     const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) return false;
+    for (const ConnectionRecord& c : connections)
+        file << c.from << '\t' << c.to << '\t' << c.pipe_id << '\n';
+    return static_cast<bool>(file);
+}
+
+bool loadConnections(std::vector<ConnectionRecord>& connections,
+                     const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) return false;
+    connections.clear();
+    ConnectionRecord c;
+    while (file >> c.from >> c.to >> c.pipe_id) connections.push_back(c);
+    return file.eof();          // arrêt sur autre chose que la fin → fichier corrompu
+}
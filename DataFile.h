@@ -0,0 +1,28 @@
+// DataFile.h
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Pipe.h"
+#include "KC.h"
+
+// Sauvegarde / chargement du fichier de données (format texte tabulé :
+// nombre de pipes, pipes, nombre de KC, KC) ; false en cas d'échec
+bool saveToFile(const std::unordered_map<int, Pipe>& pipes,
+                const std::unordered_map<int, KC>& companies,
+                const std::string& filename);
+bool loadFromFile(std::unordered_map<int, Pipe>& pipes,
+                  std::unordered_map<int, KC>& companies,
+                  std::string& filename);
+
+// Liste de connexions (une ligne « from<TAB>to<TAB>pipe_id » par arête),
+// produite par le générateur de réseaux synthétiques
+struct ConnectionRecord {
+    int from;
+    int to;
+    int pipe_id;
+};
+bool saveConnections(const std::vector<ConnectionRecord>& connections,
+                     const std::string& filename);
+bool loadConnections(std::vector<ConnectionRecord>& connections,
+                     const std::string& filename);
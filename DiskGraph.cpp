@@ -0,0 +1,289 @@
+#include "DiskGraph.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+namespace {
+const char MAGIC[8] = { 'G', 'A', 'S', 'D', 'I', 'S', 'K', '1' };
+
+enum Section { KC_IDS, OFFSETS, TARGETS, PIPE_IDS, CAPACITIES, WEIGHTS, PIPES, SECTIONS };
+
+const std::size_t WRITE_BUFFER = std::size_t(1) << 20;    // par section
+
+std::uint64_t alignPage(std::uint64_t at) {
+    return (at + DiskGraph::PAGE - 1) / DiskGraph::PAGE * DiskGraph::PAGE;
+}
+
+// section [at, at + count × size) alignée, après l'en-tête, dans le fichier
+bool sectionFits(std::uint64_t at, std::uint64_t count, std::uint64_t size, std::uint64_t fileSize) {
+    if (at < DiskGraph::PAGE || at % DiskGraph::PAGE != 0 || at > fileSize) return false;
+    return count <= (fileSize - at) / size;            // sans débordement
+}
+
+// Un en-tête corrompu ne doit mener à aucune lecture hors des sections
+bool validLayout(const DiskGraph::Header& h, std::uint64_t actualSize) {
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (h.fileSize > actualSize) return false;         // fichier tronqué
+    if (h.nodes >= static_cast<std::uint64_t>(std::numeric_limits<std::int32_t>::max())) return false;
+    return sectionFits(h.kcIdsAt,      h.nodes,     4, h.fileSize) &&
+           sectionFits(h.offsetsAt,    h.nodes + 1, 8, h.fileSize) &&
+           sectionFits(h.targetsAt,    h.edges,     4, h.fileSize) &&
+           sectionFits(h.pipeIdsAt,    h.edges,     4, h.fileSize) &&
+           sectionFits(h.capacitiesAt, h.edges,     8, h.fileSize) &&
+           sectionFits(h.weightsAt,    h.edges,     4, h.fileSize) &&
+           sectionFits(h.pipesAt,      h.pipes,     sizeof(DiskGraph::PipeRecord), h.fileSize);
+}
+}
+
+const std::uint64_t DiskGraph::PAGE;
+const std::size_t   DiskGraph::MIN_CACHE_CHUNKS;
+
+/*======================================================================
+   ÉCRITURE – une section par flux, en une seule passe
+======================================================================*/
+bool DiskGraph::Writer::open(const std::string& filename, std::uint64_t nodes,
+                             std::uint64_t edges, std::uint64_t pipes) {
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.nodes = nodes;
+    header.edges = edges;
+    header.pipes = pipes;
+    std::uint64_t at = PAGE;                           // page 0 : en-tête
+    auto place = [&at](std::uint64_t bytes) {
+        std::uint64_t begin = at;
+        at = alignPage(at + bytes);
+        return begin;
+    };
+    header.kcIdsAt      = place(4 * nodes);
+    header.offsetsAt    = place(8 * (nodes + 1));
+    header.targetsAt    = place(4 * edges);
+    header.pipeIdsAt    = place(4 * edges);
+    header.capacitiesAt = place(8 * edges);
+    header.weightsAt    = place(4 * edges);
+    header.pipesAt      = place(sizeof(PipeRecord) * pipes);
+    header.fileSize     = at;
+
+    {                                                  // fichier à sa taille finale
+        std::ofstream create(filename, std::ios::binary | std::ios::trunc);
+        if (!create.is_open()) return false;
+        create.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        create.seekp(static_cast<std::streamoff>(header.fileSize - 1));
+        create.put('\0');
+        if (!create) return false;
+    }
+
+    const std::uint64_t starts[SECTIONS] = { header.kcIdsAt, header.offsetsAt, header.targetsAt,
+        header.pipeIdsAt, header.capacitiesAt, header.weightsAt, header.pipesAt };
+    out.clear();
+    buffers.assign(SECTIONS, std::vector<char>(WRITE_BUFFER));
+    for (int k = 0; k < SECTIONS; ++k) {
+        out.emplace_back(new std::ofstream());
+        out[k]->rdbuf()->pubsetbuf(buffers[k].data(), buffers[k].size());  // avant open()
+        out[k]->open(filename, std::ios::binary | std::ios::in | std::ios::out);
+        if (!out[k]->is_open()) return false;
+        out[k]->seekp(static_cast<std::streamoff>(starts[k]));
+    }
+    nodeCount = edgeCount = pipeCount = 0;
+    lastPipe = std::numeric_limits<int>::min();
+    failed = false;
+    return true;
+}
+
+void DiskGraph::Writer::addNode(int kc_id) {
+    if (nodeCount >= header.nodes) { failed = true; return; }
+    if (nodeCount > 0 && kc_id <= lastNode) failed = true;
+    lastNode = kc_id;
+    put(KC_IDS, static_cast<std::int32_t>(kc_id));
+    put(OFFSETS, edgeCount);
+    ++nodeCount;
+}
+
+void DiskGraph::Writer::addEdge(int target, int pipe_id, FlowType capacity, float weight) {
+    if (nodeCount == 0 || edgeCount >= header.edges ||
+        target < 0 || static_cast<std::uint64_t>(target) >= header.nodes) { failed = true; return; }
+    put(TARGETS, static_cast<std::int32_t>(target));
+    put(PIPE_IDS, static_cast<std::int32_t>(pipe_id));
+    put(CAPACITIES, static_cast<std::int64_t>(capacity));
+    put(WEIGHTS, weight);
+    ++edgeCount;
+}
+
+void DiskGraph::Writer::addPipe(const PipeRecord& pipe) {
+    if (pipeCount >= header.pipes || pipe.id <= lastPipe) { failed = true; return; }
+    lastPipe = pipe.id;
+    put(PIPES, pipe);
+    ++pipeCount;
+}
+
+bool DiskGraph::Writer::finish() {
+    if (out.empty()) return false;
+    put(OFFSETS, edgeCount);                           // offsets[n]
+    bool ok = !failed && nodeCount == header.nodes && edgeCount == header.edges &&
+              pipeCount == header.pipes;
+    for (auto& s : out) {
+        s->flush();
+        ok = ok && static_cast<bool>(*s);
+        s->close();
+    }
+    out.clear();
+    buffers.clear();
+    return ok;
+}
+
+DiskGraph::PipeRecord DiskGraph::record(const Pipe& pipe) {
+    PipeRecord r;
+    r.id       = pipe.getId();
+    r.diameter = pipe.getDiameter();
+    r.length   = pipe.getLength();
+    r.weight   = pipe.getWeight();
+    r.capacity = pipe.getCapacity();
+    r.repair   = pipe.isRepair() ? 1 : 0;
+    return r;
+}
+
+bool DiskGraph::save(const std::string& filename, const GraphSnapshot& graph,
+                     const std::unordered_map<int, Pipe>& pipes) {
+    std::vector<int> ids;
+    ids.reserve(pipes.size());
+    for (const auto& kv : pipes) ids.push_back(kv.first);
+    std::sort(ids.begin(), ids.end());
+
+    Writer w;
+    if (!w.open(filename, graph.nodeCount(), graph.edgeCount(), ids.size())) return false;
+    for (int i = 0; i < static_cast<int>(graph.nodeCount()); ++i) {
+        w.addNode(graph.kcId(i));
+        for (int e = graph.edgeBegin(i); e < graph.edgeEnd(i); ++e)
+            w.addEdge(graph.target(e), graph.pipeId(e), graph.capacity(e), graph.weight(e));
+    }
+    for (int id : ids) w.addPipe(record(pipes.at(id)));
+    return w.finish();
+}
+
+/*======================================================================
+   LECTURE
+======================================================================*/
+bool DiskGraph::open(const std::string& filename, std::size_t cacheChunks) {
+    close();
+    std::ifstream in(filename, std::ios::binary);
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (!file.open(filename, std::max(cacheChunks, MIN_CACHE_CHUNKS))) return false;
+    if (!validLayout(header, file.size())) { close(); return false; }
+    return true;
+}
+
+int DiskGraph::indexOf(int kc_id) {
+    std::uint64_t lo = 0, hi = header.nodes;           // premier kcId >= kc_id
+    while (lo < hi) {
+        std::uint64_t mid = lo + (hi - lo) / 2;
+        if (kcId(static_cast<int>(mid)) < kc_id) lo = mid + 1; else hi = mid;
+    }
+    if (lo == header.nodes || kcId(static_cast<int>(lo)) != kc_id) return -1;
+    return static_cast<int>(lo);
+}
+
+bool DiskGraph::findPipe(int pipe_id, PipeRecord& out) {
+    std::uint64_t lo = 0, hi = header.pipes;
+    while (lo < hi) {
+        std::uint64_t mid = lo + (hi - lo) / 2;
+        PipeRecord r = file.read<PipeRecord>(header.pipesAt + sizeof(PipeRecord) * mid);
+        if (r.id == pipe_id) { out = r; return true; }
+        if (r.id < pipe_id) lo = mid + 1; else hi = mid;
+    }
+    return false;
+}
+
+/*======================================================================
+   ANALYSES EN FLUX
+======================================================================*/
+std::vector<int> DiskGraph::bfsLevels(int source) {
+    const int s = indexOf(source);
+    if (s < 0) return {};
+    std::vector<int> level(nodeCount(), -1);
+    std::vector<int> frontier(1, s), next;
+    level[s] = 0;
+    for (int depth = 1; !frontier.empty(); ++depth) {
+        std::sort(frontier.begin(), frontier.end());   // indices croissants : lecture en avançant
+        next.clear();
+        for (int u : frontier) {
+            const std::uint64_t end = edgesOf(u);
+            for (std::uint64_t e = edgeBegin(u); e < end; ++e) {
+                int v = target(e);
+                if (validNode(v) && level[v] < 0) { level[v] = depth; next.push_back(v); }
+            }
+        }
+        frontier.swap(next);
+    }
+    return level;
+}
+
+std::vector<int> DiskGraph::findShortestPath(int source, int sink) {
+    const int s = indexOf(source), t = indexOf(sink);
+    if (s < 0 || t < 0) return {};
+    typedef std::pair<float,int> PQItem;
+    const std::greater<PQItem> later;
+    std::vector<float> dist(nodeCount(), std::numeric_limits<float>::infinity());
+    std::vector<int>   parent(nodeCount(), -1);
+    std::vector<PQItem> heap(1, PQItem(0.0f, s));
+    dist[s] = 0.0f;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        PQItem top = heap.back();
+        heap.pop_back();
+        int u = top.second;
+        if (top.first != dist[u]) continue;            // entrée périmée
+        if (u == t) break;
+        const std::uint64_t end = edgesOf(u);
+        for (std::uint64_t e = edgeBegin(u); e < end; ++e) {
+            float w = weight(e);
+            if (std::isinf(w)) continue;               // tuyau en réparation
+            int v = target(e);
+            if (!validNode(v)) continue;
+            float nd = top.first + w;
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                parent[v] = u;
+                heap.push_back(PQItem(nd, v));
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+    }
+    if (std::isinf(dist[t])) return {};
+    std::vector<int> path;
+    for (int cur = t; cur != -1; cur = parent[cur]) path.push_back(kcId(cur));
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<int> DiskGraph::topologicalSort() {
+    const int n = static_cast<int>(nodeCount());
+    std::vector<int> indegree(n, 0);
+    for (std::uint64_t e = 0; e < header.edges; ++e) {                         // une passe sur targets
+        int v = target(e);
+        if (validNode(v)) ++indegree[v];
+    }
+
+    std::vector<int> order, level, next;
+    order.reserve(n);
+    for (int i = 0; i < n; ++i) if (indegree[i] == 0) level.push_back(i);
+    while (!level.empty()) {
+        order.insert(order.end(), level.begin(), level.end());
+        next.clear();
+        for (int u : level) {                          // niveau trié : lecture en avançant
+            const std::uint64_t end = edgesOf(u);
+            for (std::uint64_t e = edgeBegin(u); e < end; ++e) {
+                int v = target(e);
+                if (validNode(v) && --indegree[v] == 0) next.push_back(v);
+            }
+        }
+        std::sort(next.begin(), next.end());
+        level.swap(next);
+    }
+    if (static_cast<int>(order.size()) != n) return {};      // cycle
+
+    std::vector<int> ids(n);
+    for (int k = 0; k < n; ++k) ids[k] = kcId(order[k]);
+    return ids;
+}
@@ -0,0 +1,134 @@
+// DiskGraph.h
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "GraphSnapshot.h"
+#include "PagedFile.h"
+
+// ---------------------------------------------------------------------
+//  Réseau stocké sur disque, pour les modèles qui ne tiennent pas en
+//  mémoire : seules les données par KC (distances, visites, degrés
+//  entrants) restent en RAM, les arêtes et les tuyaux sont lus par blocs
+//  via un PagedFile (petit cache LRU de blocs projetés en mémoire).
+//
+//  Fichier (ordre des octets de la machine), sections alignées sur 4 Ko :
+//    en-tête      nombre de KC, d'arêtes, de tuyaux, position des sections
+//    kcIds        int32    × KC       (croissants)
+//    offsets      uint64   × (KC + 1) (arêtes de i : [offsets[i], offsets[i+1]))
+//    targets      int32    × arêtes   (indice dense de la destination)
+//    pipeIds      int32    × arêtes
+//    capacities   int64    × arêtes   (0 si en réparation)
+//    weights      float    × arêtes   (+inf si en réparation)
+//    pipes        PipeRecord × tuyaux (IDs croissants ; sans les noms)
+//  Même CSR que GraphSnapshot, une colonne par section : un parcours ne
+//  lit que les colonnes dont il a besoin, dans l'ordre du fichier.
+//
+//  Écriture en flux (Writer) : une KC après l'autre, chacune suivie de
+//  ses arêtes ; le Writer ne garde que le tampon de chaque section.
+//  save() écrit une version figée (la GraphSnapshot est déjà en mémoire),
+//  NetworkGenerator::writeDiskGraph un réseau généré sans passer par les
+//  maps, mais avec sa liste de connexions et les tableaux du tri par
+//  origine en RAM (≈ 16 octets par arête, 8 par KC).
+//
+//  Lecture : main --disk FICHIER répond aux requêtes JSON shortest_path,
+//  bfs et topological_sort (CommandProcessor::answerDiskQuery).
+//
+//  Parcours en flux : la frontière d'un BFS et chaque niveau du tri
+//  topologique sont traités par indices croissants, donc offsets et
+//  targets sont lus en avançant dans le fichier ; Dijkstra garde les
+//  blocs de ses KC les plus proches dans le cache. Un seul thread par
+//  DiskGraph (ouvrir le fichier une fois par lecteur).
+// ---------------------------------------------------------------------
+class DiskGraph {
+public:
+    typedef GraphSnapshot::FlowType FlowType;
+    static const std::uint64_t PAGE = 4096;
+    // blocs lus à chaque pas d'un parcours (offsets, targets, weights,
+    // kcIds) : en dessous, chaque lecture évincerait un bloc (mmap / munmap)
+    static const std::size_t   MIN_CACHE_CHUNKS = 4;
+
+    struct PipeRecord {                  // 32 octets
+        std::int32_t id = 0;
+        std::int32_t diameter = 0;
+        float        length = 0.0f;
+        float        weight = 0.0f;      // +inf si en réparation
+        std::int64_t capacity = 0;       // 0 si en réparation
+        std::int32_t repair = 0;
+        std::int32_t reserved = 0;
+    };
+
+    struct Header {
+        char          magic[8];
+        std::uint64_t nodes, edges, pipes;
+        std::uint64_t kcIdsAt, offsetsAt, targetsAt, pipeIdsAt, capacitiesAt, weightsAt, pipesAt;
+        std::uint64_t fileSize;
+    };
+
+    class Writer {
+    private:
+        Header                                     header;
+        std::vector<std::unique_ptr<std::ofstream>> out;    // une par section
+        std::vector<std::vector<char>>             buffers;
+        std::uint64_t                              nodeCount = 0, edgeCount = 0, pipeCount = 0;
+        int                                        lastNode = 0, lastPipe = 0;
+        bool                                       failed = false;
+
+        template<typename T> void put(int section, const T& value) {
+            out[section]->write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+    public:
+        // comptes annoncés d'avance : ils fixent la place de chaque section
+        bool open(const std::string& filename, std::uint64_t nodes, std::uint64_t edges,
+                  std::uint64_t pipes);
+        void addNode(int kc_id);                     // IDs croissants
+        void addEdge(int target, int pipe_id, FlowType capacity, float weight);  // de la dernière KC
+        void addPipe(const PipeRecord& pipe);        // IDs croissants
+        bool finish();                               // false : comptes différents ou erreur d'écriture
+    };
+
+    static PipeRecord record(const Pipe& pipe);
+    static bool save(const std::string& filename, const GraphSnapshot& graph,
+                     const std::unordered_map<int, Pipe>& pipes);
+
+private:
+    Header    header;
+    PagedFile file;
+
+    // fichier corrompu : destinations hors des KC ignorées, arêtes bornées
+    bool          validNode(int v) const { return static_cast<std::uint64_t>(static_cast<unsigned>(v)) < header.nodes; }
+    std::uint64_t edgesOf(int i)         { return std::min(edgeEnd(i), header.edges); }
+
+public:
+    // cacheChunks : blocs de PagedFile::CHUNK gardés en mémoire (au moins
+    // MIN_CACHE_CHUNKS) ; false si l'en-tête ne décrit pas des sections
+    // alignées, toutes dans le fichier
+    bool open(const std::string& filename, std::size_t cacheChunks = 16);
+    void close() { file.close(); }
+    bool isOpen() const { return file.isOpen(); }
+    const PagedFile& cache() const { return file; }
+
+    std::size_t nodeCount() const { return static_cast<std::size_t>(header.nodes); }
+    std::size_t edgeCount() const { return static_cast<std::size_t>(header.edges); }
+    std::size_t pipeCount() const { return static_cast<std::size_t>(header.pipes); }
+
+    int           kcId(int i)             { return file.read<std::int32_t>(header.kcIdsAt + 4 * std::uint64_t(i)); }
+    int           indexOf(int kc_id);                        // -1 si absent (recherche binaire)
+    std::uint64_t edgeBegin(int i)        { return file.read<std::uint64_t>(header.offsetsAt + 8 * std::uint64_t(i)); }
+    std::uint64_t edgeEnd(int i)          { return edgeBegin(i + 1); }
+    int           target(std::uint64_t e) { return file.read<std::int32_t>(header.targetsAt + 4 * e); }
+    int           pipeId(std::uint64_t e) { return file.read<std::int32_t>(header.pipeIdsAt + 4 * e); }
+    FlowType      capacity(std::uint64_t e) { return file.read<std::int64_t>(header.capacitiesAt + 8 * e); }
+    float         weight(std::uint64_t e) { return file.read<float>(header.weightsAt + 4 * e); }
+    bool          findPipe(int pipe_id, PipeRecord& out);      // recherche binaire
+
+    // Analyses en flux (IDs de KC ; KC absente → vide)
+    std::vector<int> bfsLevels(int source);                  // sauts depuis source par indice dense (-1 : inaccessible)
+    std::vector<int> findShortestPath(int source, int sink); // Dijkstra, vide si aucun chemin
+    std::vector<int> topologicalSort();                      // niveau par niveau ; vide si cycle
+};
@@ -0,0 +1,184 @@
+#include "EventLog.h"
+#include <chrono>
+#include <cstring>
+
+namespace {
+const char          MAGIC[4]        = { 'G', 'N', 'E', 'L' };
+const std::uint16_t FORMAT_VERSION  = 1;
+const std::size_t   WRITE_BUFFER    = 1 << 16;
+
+std::int64_t nowMillis() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+EventRecord makeRecord(EventType type) {
+    EventRecord rec;
+    std::memset(&rec, 0, sizeof(rec));
+    rec.type      = static_cast<std::uint8_t>(type);
+    rec.timestamp = nowMillis();
+    rec.name = rec.label = rec.classes = EVENT_NO_STRING;
+    return rec;
+}
+
+std::size_t paddedSize(std::size_t n) { return (n + 7) & ~static_cast<std::size_t>(7); }
+
+// En-tête attendu à la position courante : magic, version, taille d'un enregistrement
+bool readHeader(std::FILE* file) {
+    char magic[4];
+    std::uint16_t header[2];
+    if (std::fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+        std::fread(header, 1, sizeof(header), file) != sizeof(header))
+        return false;
+    return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 &&
+           header[0] == FORMAT_VERSION &&
+           header[1] == sizeof(EventRecord);
+}
+}
+
+/*======================================================================
+   WRITER
+======================================================================*/
+BinaryEventLog::BinaryEventLog(const std::string& path)
+    : file(std::fopen(path.c_str(), "a+b")), buffer(WRITE_BUFFER) {
+    if (!file) return;
+    std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+
+    // en-tête si le fichier est neuf ; sinon on n'ajoute qu'à un journal de
+    // ce format dont la fin est alignée (sinon la suite serait illisible)
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    if (size != 0) {
+        std::rewind(file);
+        bool ours = size % 8 == 0 && readHeader(file);
+        if (!ours || std::fseek(file, 0, SEEK_END) != 0) {   // fseek : lecture → écriture
+            std::fclose(file);
+            file = nullptr;
+            return;
+        }
+    } else {
+        std::uint16_t header[2] = { FORMAT_VERSION,
+                                    static_cast<std::uint16_t>(sizeof(EventRecord)) };
+        std::fwrite(MAGIC, 1, sizeof(MAGIC), file);
+        std::fwrite(header, 1, sizeof(header), file);
+    }
+    EventRecord start = makeRecord(EventType::SessionStart);
+    write(start);
+}
+
+BinaryEventLog::~BinaryEventLog() {
+    if (file) std::fclose(file);
+}
+
+void BinaryEventLog::flush() {
+    if (file) std::fflush(file);
+}
+
+void BinaryEventLog::write(EventRecord& rec) {
+    std::fwrite(&rec, sizeof(rec), 1, file);
+}
+
+std::uint32_t BinaryEventLog::intern(const std::string& s) {
+    auto it = strings.find(s);
+    if (it != strings.end()) return it->second;
+
+    std::uint32_t ref = static_cast<std::uint32_t>(strings.size());
+    strings.emplace(s, ref);
+
+    EventRecord def = makeRecord(EventType::StringDef);
+    def.id = static_cast<std::int32_t>(ref);
+    def.a  = static_cast<std::int32_t>(s.size());
+    write(def);
+
+    static const char zeros[8] = {};
+    std::fwrite(s.data(), 1, s.size(), file);
+    std::fwrite(zeros, 1, paddedSize(s.size()) - s.size(), file);
+    return ref;
+}
+
+void BinaryEventLog::text(const std::string& action) {
+    if (!file) return;
+    EventRecord rec = makeRecord(EventType::Text);
+    rec.label = intern(action);
+    write(rec);
+}
+
+void BinaryEventLog::pipe(EventType type, const std::string& label, int id,
+                          const std::string& name, double length,
+                          int diameter, bool repair) {
+    if (!file) return;
+    EventRecord rec = makeRecord(type);
+    rec.id     = id;
+    rec.name   = intern(name);
+    if (type == EventType::PipeAction) rec.label = intern(label);
+    rec.length = length;
+    rec.a      = diameter;
+    rec.flags  = repair ? EVENT_FLAG_REPAIR : 0;
+    write(rec);
+}
+
+void BinaryEventLog::company(EventType type, const std::string& label, int id,
+                             const std::string& name, int workshops,
+                             int workshopsInOperation, const std::string& classes) {
+    if (!file) return;
+    EventRecord rec = makeRecord(type);
+    rec.id      = id;
+    rec.name    = intern(name);
+    rec.classes = intern(classes);
+    if (type == EventType::CompanyAction) rec.label = intern(label);
+    rec.a       = workshops;
+    rec.b       = workshopsInOperation;
+    write(rec);
+}
+
+/*======================================================================
+   READER
+======================================================================*/
+BinaryEventReader::BinaryEventReader(const std::string& path)
+    : file(std::fopen(path.c_str(), "rb")), valid(false), corrupt(false), fileSize(0) {
+    if (!file) return;
+    if (std::fseek(file, 0, SEEK_END) == 0) fileSize = std::ftell(file);
+    std::rewind(file);
+    valid = readHeader(file);
+}
+
+BinaryEventReader::~BinaryEventReader() {
+    if (file) std::fclose(file);
+}
+
+bool BinaryEventReader::next(EventRecord& rec) {
+    if (!valid) return false;
+    while (std::fread(&rec, sizeof(rec), 1, file) == 1) {
+        EventType type = static_cast<EventType>(rec.type);
+        if (type == EventType::SessionStart) {
+            strings.clear();
+            return true;
+        }
+        if (type != EventType::StringDef) return true;
+
+        // l'écrivain numérote les chaînes dans l'ordre, octets juste après
+        long left = fileSize - std::ftell(file);
+        if (rec.a < 0 || rec.a > left || rec.id < 0 ||
+            static_cast<std::size_t>(rec.id) > strings.size()) {
+            corrupt = true;
+            break;
+        }
+        std::string s(static_cast<std::size_t>(rec.a), '\0');
+        std::size_t padded = paddedSize(s.size());
+        if (!s.empty() && std::fread(&s[0], 1, s.size(), file) != s.size()) {
+            corrupt = true;
+            break;
+        }
+        if (padded != s.size()) std::fseek(file, static_cast<long>(padded - s.size()), SEEK_CUR);
+        if (static_cast<std::size_t>(rec.id) >= strings.size())
+            strings.resize(static_cast<std::size_t>(rec.id) + 1);
+        strings[static_cast<std::size_t>(rec.id)] = std::move(s);
+    }
+    valid = false;          // fin de fichier (ou fichier tronqué, ou corrompu)
+    return false;
+}
+
+const std::string& BinaryEventReader::str(std::uint32_t ref) const {
+    if (ref == EVENT_NO_STRING || ref >= strings.size()) return empty;
+    return strings[ref];
+}
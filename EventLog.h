@@ -0,0 +1,105 @@
+// EventLog.h
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// ---------------------------------------------------------------------
+//  Journal binaire des actions utilisateur
+//
+//  Fichier = en-tête (8 octets) + suite d'enregistrements de taille fixe.
+//  Les chaînes (noms, classes, libellés) sont internées : la première
+//  occurrence est écrite une seule fois sous forme d'un enregistrement
+//  StringDef suivi de ses octets (complétés à un multiple de 8), ensuite
+//  seule la référence (index) est stockée. Chaque ouverture du journal
+//  commence par un SessionStart qui remet la table des chaînes à zéro, ce
+//  qui permet d'ajouter à un fichier existant sans le relire : seul son
+//  en-tête est vérifié. Un fichier non vide qui n'est pas un journal de
+//  ce format (ou dont la taille n'est pas un multiple de 8) est refusé,
+//  isOpen() renvoie alors false.
+// ---------------------------------------------------------------------
+
+enum class EventType : std::uint8_t {
+    SessionStart   = 0,
+    StringDef      = 1,
+    Text           = 2,   // logAction(texte libre)
+    PipeSimple     = 3,   // logPipeSimple
+    PipeAction     = 4,   // logAction(libellé, pipe)
+    CompanySimple  = 5,   // logCompanySimple
+    CompanyAction  = 6    // logAction(libellé, company)
+};
+
+struct EventRecord {
+    std::int64_t  timestamp;   // millisecondes depuis l'époque Unix
+    double        length;      // longueur du tuyau
+    std::int32_t  id;          // ID de l'objet (ou index pour StringDef)
+    std::uint32_t name;        // référence de chaîne
+    std::uint32_t label;       // libellé d'action ou texte libre
+    std::uint32_t classes;     // classes de la KC
+    std::int32_t  a;           // diamètre / nombre d'ateliers / taille d'une chaîne
+    std::int32_t  b;           // ateliers en fonctionnement
+    std::uint8_t  type;        // EventType
+    std::uint8_t  flags;       // bit 0 : tuyau en réparation
+    std::uint16_t reserved;
+    std::uint32_t padding;
+};
+static_assert(sizeof(EventRecord) == 48, "EventRecord must stay 48 bytes");
+
+const std::uint32_t EVENT_NO_STRING = 0xFFFFFFFFu;
+const std::uint8_t  EVENT_FLAG_REPAIR = 0x01;
+
+class BinaryEventLog {
+private:
+    std::FILE* file;
+    std::unordered_map<std::string, std::uint32_t> strings;
+    std::vector<char> buffer;              // tampon stdio
+
+    std::uint32_t intern(const std::string& s);
+    void write(EventRecord& rec);
+
+public:
+    explicit BinaryEventLog(const std::string& path);
+    ~BinaryEventLog();
+    BinaryEventLog(const BinaryEventLog&) = delete;
+    BinaryEventLog& operator=(const BinaryEventLog&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+    void flush();
+
+    void text(const std::string& action);
+    void pipe(EventType type, const std::string& label, int id,
+              const std::string& name, double length, int diameter, bool repair);
+    void company(EventType type, const std::string& label, int id,
+                 const std::string& name, int workshops,
+                 int workshopsInOperation, const std::string& classes);
+};
+
+class BinaryEventReader {
+private:
+    std::FILE* file;
+    std::vector<std::string> strings;
+    std::string empty;
+    bool valid;
+    bool corrupt;
+    long fileSize;
+
+public:
+    explicit BinaryEventReader(const std::string& path);
+    ~BinaryEventReader();
+    BinaryEventReader(const BinaryEventReader&) = delete;
+    BinaryEventReader& operator=(const BinaryEventReader&) = delete;
+
+    bool isValid() const { return valid; }
+    // StringDef incohérent (taille au-delà de la fin du fichier, index qui
+    // saute des chaînes, octets tronqués) : lecture arrêtée, next() a
+    // renvoyé false
+    bool isCorrupt() const { return corrupt; }
+
+    // Renvoie le prochain évènement « métier » ; les StringDef sont
+    // absorbés et SessionStart est renvoyé pour que l'appelant puisse
+    // remettre ses compteurs à zéro.
+    bool next(EventRecord& rec);
+    const std::string& str(std::uint32_t ref) const;
+};
@@ -1,4 +1,7 @@
 #include "GasNetwork.h"
+#include "ScenarioOverlay.h"
+#include "GraphSnapshot.h"
+#include "RegionPartition.h"
 #include <iostream>
 #include <unordered_map>
 #include <algorithm>
@@ -9,11 +12,15 @@
 #include <vector>
 #include <limits>
 #include <cmath>
+#include <cstdint>
+#include <unordered_set>
 
 /*======================================================================
    Constructeur
 ======================================================================*/
-GasNetwork::GasNetwork() {}
+GasNetwork::GasNetwork(const PipeRegistry& registry) : pipes(&registry) {
+    refreshPipes();                            // registre éventuellement déjà rempli
+}
 
 /*======================================================================
    BASE HELPERS
@@ -27,10 +34,51 @@ bool GasNetwork::connectionExists(int from, int to) const {
 }
 
 /*======================================================================
-   REGISTER PIPE – enregistrement dès la création
+   REFRESH EDGE – capacité / poids lus dans le registre
+======================================================================*/
+void GasNetwork::refreshEdge(Edge& e) const {
+    auto it = pipes->find(e.pipe_id);
+    if (it == pipes->end()) {                  // tuyau disparu : arête inutilisable
+        e.capacity = 0;
+        e.weight   = std::numeric_limits<float>::infinity();
+        return;
+    }
+    e.capacity = static_cast<Edge::FlowType>(it->second.getCapacity());
+    e.weight   = it->second.getWeight();
+}
+
+/*======================================================================
+   FREE PIPES – seaux par diamètre
 ======================================================================*/
-void GasNetwork::registerPipe(int pipe_id, const Pipe& pipe) {
-    pipes[pipe_id] = pipe;                     // on garde les infos du tuyau
+void GasNetwork::addFree(int pipe_id, int diameter) {
+    removeFree(pipe_id);
+    freePipes[diameter].insert(pipe_id);
+    freeDiameter[pipe_id] = diameter;
+}
+
+void GasNetwork::removeFree(int pipe_id) {
+    auto it = freeDiameter.find(pipe_id);
+    if (it == freeDiameter.end()) return;
+    auto bucket = freePipes.find(it->second);
+    bucket->second.erase(pipe_id);
+    if (bucket->second.empty()) freePipes.erase(bucket);
+    freeDiameter.erase(it);
+}
+
+std::vector<int> GasNetwork::availableDiameters() const {
+    std::vector<int> diameters;
+    for (const auto& kv : freePipes) diameters.push_back(kv.first);
+    return diameters;
+}
+
+std::size_t GasNetwork::unusedPipeCount(int diameter) const {
+    auto it = freePipes.find(diameter);
+    return it == freePipes.end() ? 0 : it->second.size();
+}
+
+int GasNetwork::firstUnusedPipe(int diameter) const {
+    auto it = freePipes.find(diameter);
+    return it == freePipes.end() ? -1 : *it->second.begin();
 }
 
 /*======================================================================
@@ -40,47 +88,305 @@ bool GasNetwork::addConnection(int from, int to, int pipe_id) {
     if (connectionExists(from, to)) return false;          // déjà existante
 
     // le tuyau doit être présent dans le registre de pipes
-    auto pIt = pipes.find(pipe_id);
-    if (pIt == pipes.end()) {
+    if (pipes->find(pipe_id) == pipes->end()) {
         std::cerr << "Pipe ID " << pipe_id << " not registered in the network.\n";
         return false;
     }
-    const Pipe& p = pIt->second;
+
+    // cycle ⇔ « to » atteint déjà « from » (boucle from == to comprise) :
+    // l'index refuse l'arête sans parcourir tout le graphe
+    if (!currentReachability().addEdge(from, to)) return false;
 
     Edge e;
     e.to       = to;
     e.pipe_id  = pipe_id;
-    e.capacity = static_cast<Edge::FlowType>(p.getCapacity());   
     e.flow     = 0;
-    e.weight   = p.getWeight();                                
+    refreshEdge(e);
 
-    // insertion temporaire → test de cycle
     graph[from].push_back(e);
-    if (hasCycle()) {                     // crée un cycle → annuler
-        graph[from].pop_back();
-        return false;
-    }
+    if (!componentsStale) componentIndex.unite(from, to);
+    pipeSources[pipe_id].push_back(from);
+    removeFree(pipe_id);
+    ++version;
+    ++topologyVersion;
     return true;
 }
 
+/*======================================================================
+   BULK IMPORT – addConnections
+   1. doublons (hachage) et tuyaux inconnus, dans l'ordre du lot ;
+   2. Kahn sur graphe existant + lot : si tous les nœuds sortent, aucun
+      cycle, tout est accepté ;
+   3. sinon seuls les nœuds restants (sur un cycle ou en aval) peuvent en
+      porter un : leurs arêtes sont rejouées dans l'ordre, chacune refusée
+      si « to » atteint déjà « from » (DFS limité à ces nœuds) ;
+   4. insertion des arêtes acceptées.
+======================================================================*/
+namespace {
+// Au-delà, reconstruire l'index d'atteignabilité (à la demande) coûte
+// moins que le mettre à jour arête par arête
+const std::size_t REACH_INCREMENTAL_BATCH = 64;
+
+inline std::uint64_t pairKey(int from, int to) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(from)) << 32) |
+            static_cast<std::uint32_t>(to);
+}
+}
+
+std::vector<GasNetwork::RejectedConnection>
+GasNetwork::addConnections(const std::vector<ConnectionRecord>& batch) {
+    std::vector<RejectedConnection> rejected;
+    std::vector<char> keep(batch.size(), 0);
+
+    /* ---------- 1. doublons / tuyaux inconnus ---------- */
+    std::unordered_map<std::uint64_t, std::size_t> firstOf;      // paire → 1re arête du lot
+    std::vector<std::pair<std::size_t, std::size_t>> repeats;    // (doublon, 1re arête)
+    std::unordered_set<std::uint64_t> existing;
+    firstOf.reserve(batch.size());
+    {                                                  // arêtes existantes des sources du lot
+        std::unordered_set<int> sources;
+        for (const ConnectionRecord& c : batch) sources.insert(c.from);
+        for (int s : sources) {
+            auto it = graph.find(s);
+            if (it == graph.end()) continue;
+            for (const Edge& e : it->second) existing.insert(pairKey(s, e.to));
+        }
+    }
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        const ConnectionRecord& c = batch[i];
+        std::uint64_t key = pairKey(c.from, c.to);
+        auto first = firstOf.find(key);
+        if (existing.count(key)) {
+            rejected.push_back(RejectedConnection{i, RejectReason::Duplicate});
+        } else if (first != firstOf.end()) {
+            rejected.push_back(RejectedConnection{i, RejectReason::Duplicate});
+            repeats.push_back(std::make_pair(rejected.size() - 1, first->second));
+        } else if (pipes->find(c.pipe_id) == pipes->end()) {
+            rejected.push_back(RejectedConnection{i, RejectReason::UnknownPipe});
+        } else {
+            firstOf.emplace(key, i);
+            keep[i] = 1;
+        }
+    }
+
+    /* ---------- 2. Kahn sur graphe existant + lot ---------- */
+    std::unordered_map<int, int> idx;                  // KC → indice dense
+    auto indexOf = [&idx](int kc) {
+        auto ins = idx.emplace(kc, static_cast<int>(idx.size()));
+        return ins.first->second;
+    };
+    std::vector<std::pair<int,int>> arcs;              // (u, v) denses
+    for (const auto& kv : graph) {
+        int u = indexOf(kv.first);
+        for (const Edge& e : kv.second) arcs.push_back(std::make_pair(u, indexOf(e.to)));
+    }
+    const std::size_t existingArcs = arcs.size();
+    for (std::size_t i = 0; i < batch.size(); ++i)
+        if (keep[i]) arcs.push_back(std::make_pair(indexOf(batch[i].from), indexOf(batch[i].to)));
+
+    const int n = static_cast<int>(idx.size());
+    std::vector<int> start(n + 1, 0), target(arcs.size()), indeg(n, 0);
+    for (const auto& a : arcs) { ++start[a.first + 1]; ++indeg[a.second]; }
+    for (int u = 0; u < n; ++u) start[u + 1] += start[u];
+    {
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (const auto& a : arcs) target[fill[a.first]++] = a.second;
+    }
+    std::vector<char> removed(n, 0);
+    std::vector<int> queue;
+    for (int u = 0; u < n; ++u) if (indeg[u] == 0) queue.push_back(u);
+    for (std::size_t q = 0; q < queue.size(); ++q) {
+        int u = queue[q];
+        removed[u] = 1;
+        for (int k = start[u]; k < start[u + 1]; ++k)
+            if (--indeg[target[k]] == 0) queue.push_back(target[k]);
+    }
+
+    /* ---------- 3. nœuds restants : rejeu dans l'ordre ---------- */
+    if (static_cast<int>(queue.size()) != n) {
+        std::vector<std::vector<int>> residual(n);     // arcs entre nœuds restants
+        for (std::size_t k = 0; k < existingArcs; ++k)
+            if (!removed[arcs[k].first] && !removed[arcs[k].second])
+                residual[arcs[k].first].push_back(arcs[k].second);
+
+        std::vector<int> seen(n, -1), stack;
+        std::unordered_set<std::uint64_t> cycleKeys;
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            if (!keep[i]) continue;
+            int u = idx[batch[i].from], v = idx[batch[i].to];
+            if (removed[u] || removed[v]) continue;    // hors de tout cycle
+
+            bool reaches = false;                      // v atteint-il u ?
+            stack.assign(1, v);
+            seen[v] = static_cast<int>(i);
+            while (!stack.empty() && !reaches) {
+                int x = stack.back(); stack.pop_back();
+                if (x == u) { reaches = true; break; }
+                for (int y : residual[x])
+                    if (seen[y] != static_cast<int>(i)) { seen[y] = static_cast<int>(i); stack.push_back(y); }
+            }
+            if (reaches) {
+                keep[i] = 0;
+                rejected.push_back(RejectedConnection{i, RejectReason::Cycle});
+                cycleKeys.insert(pairKey(batch[i].from, batch[i].to));
+            } else {
+                residual[u].push_back(v);
+            }
+        }
+        // le « doublon » d'une arête refusée pour cycle n'en est pas un pour
+        // addConnection : tuyau inconnu, sinon cycle (le graphe n'a fait que croître)
+        for (const auto& r : repeats)
+            if (cycleKeys.count(pairKey(batch[r.second].from, batch[r.second].to)))
+                rejected[r.first].reason = pipes->count(batch[rejected[r.first].index].pipe_id)
+                                           ? RejectReason::Cycle : RejectReason::UnknownPipe;
+    }
+
+    /* ---------- 4. insertion ---------- */
+    const std::size_t accepted = batch.size() - rejected.size();
+    const bool incremental = accepted <= REACH_INCREMENTAL_BATCH;
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        if (!keep[i]) continue;
+        const ConnectionRecord& c = batch[i];
+        Edge e;
+        e.to      = c.to;
+        e.pipe_id = c.pipe_id;
+        e.flow    = 0;
+        refreshEdge(e);
+        graph[c.from].push_back(e);
+        if (incremental && !reachabilityStale) reachability.addEdge(c.from, c.to);
+        if (incremental && !componentsStale) componentIndex.unite(c.from, c.to);
+        pipeSources[c.pipe_id].push_back(c.from);
+        removeFree(c.pipe_id);
+    }
+    if (!incremental) {                                // index refaits à la première question
+        reachabilityStale = true;
+        componentsStale   = true;
+    }
+    if (rejected.size() < batch.size()) { ++version; ++topologyVersion; }   // une version pour le lot
+    std::sort(rejected.begin(), rejected.end(),
+              [](const RejectedConnection& a, const RejectedConnection& b) { return a.index < b.index; });
+    return rejected;
+}
+
 /*======================================================================
    PIPE‑RELATED QUERIES
 ======================================================================*/
 bool GasNetwork::isPipeUsed(int pipe_id) const {
-    for (const auto& kv : graph)
-        for (const Edge& e : kv.second)
-            if (e.pipe_id == pipe_id) return true;
-    return false;
+    return pipeSources.find(pipe_id) != pipeSources.end();
 }
 bool GasNetwork::isPipeInNetwork(int pipe_id) const { return isPipeUsed(pipe_id); }
 
 void GasNetwork::removeConnectionByPipe(int pipe_id) {
-    for (auto& kv : graph) {
-        auto& vec = kv.second;
+    auto src = pipeSources.find(pipe_id);
+    if (src == pipeSources.end()) return;
+    for (int from : src->second) {
+        auto& vec = graph[from];
+        for (const Edge& e : vec)
+            if (e.pipe_id == pipe_id && !reachabilityStale) reachability.removeEdge(from, e.to);
         vec.erase(std::remove_if(vec.begin(), vec.end(),
                                  [pipe_id](const Edge& e){ return e.pipe_id == pipe_id; }),
                   vec.end());
     }
+    pipeSources.erase(src);
+    auto p = pipes->find(pipe_id);                         // redevient libre
+    if (p != pipes->end()) addFree(pipe_id, p->second.getDiameter());
+    componentsStale = true;                                // une union ne se défait pas
+    ++version;
+    ++topologyVersion;
+}
+
+// Nœuds : sources du graphe (même sans arête restante) et destinations
+ReachabilityIndex& GasNetwork::currentReachability() {
+    if (reachabilityStale) {
+        std::vector<int> nodes;
+        std::vector<std::pair<int,int>> edges;
+        nodes.reserve(graph.size());
+        for (const auto& kv : graph) {
+            nodes.push_back(kv.first);
+            for (const Edge& e : kv.second) edges.push_back(std::make_pair(kv.first, e.to));
+        }
+        reachability.rebuild(nodes, edges);
+        reachabilityStale = false;
+    }
+    return reachability;
+}
+
+/*======================================================================
+   COMPOSANTES CONNEXES
+======================================================================*/
+const ComponentIndex& GasNetwork::currentComponents() {
+    if (componentsStale) {
+        componentIndex.clear();
+        for (const auto& kv : graph) {
+            componentIndex.add(kv.first);              // source même sans arête restante
+            for (const Edge& e : kv.second) componentIndex.unite(kv.first, e.to);
+        }
+        componentsStale = false;
+    }
+    return componentIndex;
+}
+
+bool GasNetwork::sameComponent(int a, int b) { return currentComponents().connected(a, b); }
+std::size_t GasNetwork::componentCount()     { return currentComponents().componentCount(); }
+std::vector<std::vector<int>> GasNetwork::components() { return currentComponents().groups(); }
+
+// Un scénario qui retire des arêtes peut rendre une KC absente, un
+// scénario qui en ajoute peut relier deux composantes : calcul complet.
+// Lecture seule des deux index (connected, excludes) : plusieurs scénarios
+// peuvent passer ici en même temps ; index périmé : pas de raccourci.
+bool GasNetwork::provablyDisconnected(int source, int sink, const ScenarioOverlay* scenario) const {
+    if (scenario && !scenario->keepsTopology()) return false;
+    if (componentsStale) return false;
+    const ComponentIndex& c = componentIndex;
+    if (!c.contains(source) || !c.contains(sink)) return false;   // message « not present »
+    return !c.connected(source, sink) ||
+           (!reachabilityStale && reachability.excludes(source, sink));
+}
+
+/*======================================================================
+   PUBLICATION – version figée pour les lecteurs
+======================================================================*/
+void GasNetwork::publish() {
+    currentReachability();                             // index prêts pour les analyses const
+    currentComponents();
+    std::shared_ptr<const GraphSnapshot> current = std::atomic_load(&published);
+    if (current && current->version() == version) return;
+    std::shared_ptr<const GraphSnapshot::Topology> topology;
+    if (current && publishedTopology == topologyVersion) topology = current->topology();
+    std::shared_ptr<const GraphSnapshot> next =
+        std::make_shared<GraphSnapshot>(graph, version, topology);
+    publishedTopology = topologyVersion;
+    std::atomic_store(&published, next);
+    if (hasRegions()) rebuildPartition(next);
+}
+
+std::shared_ptr<const GraphSnapshot> GasNetwork::snapshot() const {
+    return std::atomic_load(&published);
+}
+
+/*======================================================================
+   RÉGIONS – découpage de la version courante
+======================================================================*/
+void GasNetwork::setRegions(const std::unordered_map<int, int>& regionOfKc) {
+    regionOf = regionOfKc;
+    std::shared_ptr<const GraphSnapshot> current = std::atomic_load(&published);
+    rebuildPartition(current && current->version() == version ? current : nullptr);
+}
+
+void GasNetwork::rebuildPartition(std::shared_ptr<const GraphSnapshot> current) {
+    if (regionOf.empty()) { regionPartition.reset(); return; }
+    if (!current) {                                    // version privée, topologie réutilisée si possible
+        std::shared_ptr<const GraphSnapshot> last = std::atomic_load(&published);
+        std::shared_ptr<const GraphSnapshot::Topology> topology;
+        if (last && publishedTopology == topologyVersion) topology = last->topology();
+        current = std::make_shared<GraphSnapshot>(graph, version, topology);
+    }
+    regionPartition = std::make_shared<RegionPartition>(current, regionOf);
+}
+
+std::shared_ptr<const RegionPartition> GasNetwork::partition() const {
+    if (!regionPartition || regionPartition->version() != version) return nullptr;
+    return regionPartition;
 }
 
 /*======================================================================
@@ -142,64 +448,180 @@ void GasNetwork::displayConnections() const {
 }
 
 /*======================================================================
-   TOPOLOGICAL SORT (Kahn)
+   SCÉNARIOS – arêtes vues à travers un ScenarioOverlay (nullptr = réel)
 ======================================================================*/
-std::vector<int> GasNetwork::topologicalSort(const std::unordered_map<int, KC>& companies) const {
-    std::unordered_map<int,int> indeg;
-    std::unordered_map<int,std::vector<int>> adj;
-
-    for (const auto& kv : companies) {
-        indeg[kv.first] = 0;
-        adj[kv.first] = {};
+namespace {
+typedef std::unordered_map<int, std::vector<GasNetwork::Edge>> Graph;
+
+// f(arête) pour chaque arête sortant de u : arêtes retirées sautées, état
+// des tuyaux remplacé, arêtes ajoutées par le scénario en plus
+template<typename F>
+void forEachEdge(const Graph& graph, const ScenarioOverlay* scenario, int u, F f) {
+    auto it = graph.find(u);
+    if (!scenario) {                                   // réseau réel : parcours direct
+        if (it != graph.end())
+            for (const GasNetwork::Edge& e : it->second) f(e);
+        return;
     }
-
-    for (const auto& kv : graph) {
-        int from = kv.first;
-        for (const Edge& e : kv.second) {
-            adj[from].push_back(e.to);
-            indeg[e.to]++;                     // comptage indegree
+    if (it != graph.end())
+        for (const GasNetwork::Edge& e : it->second) {
+            if (scenario->isRemoved(e.pipe_id)) continue;
+            const ScenarioOverlay::PipeState* state = scenario->stateOf(e.pipe_id);
+            if (!state) { f(e); continue; }
+            GasNetwork::Edge changed = e;
+            changed.capacity = state->capacity;
+            changed.weight   = state->weight;
+            f(changed);
         }
-    }
-
-    std::queue<int> q;
-    for (const auto& kv : indeg)
-        if (kv.second == 0) q.push(kv.first);
+    auto added = scenario->added().find(u);
+    if (added != scenario->added().end())
+        for (const GasNetwork::Edge& e : added->second) f(e);
+}
 
-    std::vector<int> order;
-    while (!q.empty()) {
-        int u = q.front(); q.pop();
-        order.push_back(u);
-        for (int v : adj[u])
-            if (--indeg[v] == 0) q.push(v);
-    }
+// f(u) pour chaque KC source d'au moins une arête (réelle ou ajoutée)
+template<typename F>
+void forEachSource(const Graph& graph, const ScenarioOverlay* scenario, F f) {
+    for (const auto& kv : graph) f(kv.first);
+    if (!scenario) return;
+    for (const auto& kv : scenario->added())
+        if (!graph.count(kv.first)) f(kv.first);
+}
+}
 
-    if (order.size() != companies.size()) {
-        std::cout << "Topological sort failed: cycle detected!\n";
-        return {};
+/*======================================================================
+   TOPOLOGICAL SORT – niveaux de Kahn sur tableaux plats
+======================================================================*/
+std::vector<int> GasNetwork::topologicalSort(const std::unordered_map<int, KC>& companies,
+                                             const ScenarioOverlay* scenario) const {
+    // indices denses : KC triées par ID ; ID → indice par une table directe
+    // quand les ID sont compacts (IdAllocator), par hachage sinon
+    std::vector<int> ids;
+    ids.reserve(companies.size());
+    for (const auto& kv : companies) ids.push_back(kv.first);
+    std::sort(ids.begin(), ids.end());
+    const long long lowest = ids.empty() ? 0 : ids.front();
+    const long long span   = ids.empty() ? 0 : static_cast<long long>(ids.back()) - lowest + 1;
+    std::vector<int>             direct;
+    std::unordered_map<int, int> hashed;
+    if (span <= 4 * static_cast<long long>(ids.size()) + 64) {
+        direct.assign(static_cast<std::size_t>(span), -1);
+        for (std::size_t i = 0; i < ids.size(); ++i) direct[ids[i] - lowest] = static_cast<int>(i);
+    } else {
+        hashed.reserve(ids.size());
+        for (std::size_t i = 0; i < ids.size(); ++i) hashed[ids[i]] = static_cast<int>(i);
     }
+    auto indexOf = [&](int kc_id) {
+        if (!direct.empty() || hashed.empty()) {
+            long long k = kc_id - lowest;
+            return k < 0 || k >= span ? -1 : direct[static_cast<std::size_t>(k)];
+        }
+        auto it = hashed.find(kc_id);
+        return it == hashed.end() ? -1 : it->second;
+    };
+
+    std::vector<int> from, to;
+    bool unknown = false;
+    forEachSource(graph, scenario, [&](int u) {
+        int iu = indexOf(u);
+        forEachEdge(graph, scenario, u, [&](const Edge& e) {
+            int iv = indexOf(e.to);
+            if (iu < 0 || iv < 0) { unknown = true; return; }
+            from.push_back(iu);
+            to.push_back(iv);
+        });
+    });
+    if (unknown) return {};                    // arête vers une KC hors de companies
+
+    // CSR par comptage, puis niveaux (cycle → vide)
+    const int n = static_cast<int>(ids.size());
+    std::vector<int> offsets(n + 1, 0), targets(to.size());
+    for (int u : from) ++offsets[u + 1];
+    for (int i = 0; i < n; ++i) offsets[i + 1] += offsets[i];
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t k = 0; k < from.size(); ++k) targets[fill[from[k]]++] = to[k];
+
+    GraphSnapshot::Levels levels;
+    if (!GraphSnapshot::computeLevels(n, offsets, targets, levels)) return {};
+    std::vector<int> order(n);
+    for (int i = 0; i < n; ++i) order[i] = ids[levels.order[i]];
     return order;
 }
 
 /*======================================================================
    UPDATE PIPE – après modification de l’état (réparation / opération)
 ======================================================================*/
-void GasNetwork::updatePipeInNetwork(int pipe_id, const Pipe& pipe) {
-    for (auto& kv : graph)
-        for (Edge& e : kv.second)
+bool GasNetwork::applyPipeChange(int pipe_id) {
+    auto src = pipeSources.find(pipe_id);
+    if (src == pipeSources.end()) {                        // tuyau hors réseau
+        auto p = pipes->find(pipe_id);
+        auto f = freeDiameter.find(pipe_id);
+        if (p == pipes->end()) {                           // retiré du registre
+            if (f == freeDiameter.end()) return false;
+            removeFree(pipe_id);
+        } else {                                           // ajouté / modifié
+            if (f != freeDiameter.end() && f->second == p->second.getDiameter()) return false;
+            addFree(pipe_id, p->second.getDiameter());
+        }
+        return true;
+    }
+    bool changed = false;
+    for (int from : src->second)
+        for (Edge& e : graph[from])
             if (e.pipe_id == pipe_id) {
-                e.capacity = static_cast<Edge::FlowType>(pipe.getCapacity());
-                e.weight   = pipe.getWeight();
+                Edge before = e;
+                refreshEdge(e);
+                changed |= before.capacity != e.capacity || before.weight != e.weight;
             }
+    return changed;
+}
+
+void GasNetwork::updatePipeInNetwork(int pipe_id) {
+    if (applyPipeChange(pipe_id)) ++version;
 }
 
+void GasNetwork::updatePipesInNetwork(const std::vector<int>& pipe_ids) {
+    bool changed = false;
+    for (int id : pipe_ids) changed |= applyPipeChange(id);
+    if (changed) ++version;
+}
+
+void GasNetwork::refreshPipes() {
+    ++version;
+    for (auto& kv : graph)
+        for (Edge& e : kv.second) refreshEdge(e);
+    // seaux reconstruits : (diamètre, ID) triés puis insérés en fin de set
+    std::vector<std::pair<int,int>> free;
+    free.reserve(pipes->size());
+    for (const auto& kv : *pipes)
+        if (!isPipeUsed(kv.first)) free.push_back(std::make_pair(kv.second.getDiameter(), kv.first));
+    std::sort(free.begin(), free.end());
+    freePipes.clear();
+    freeDiameter.clear();
+    freeDiameter.reserve(free.size());
+    for (const auto& d : free) {
+        std::set<int>& bucket = freePipes[d.first];
+        bucket.insert(bucket.end(), d.second);
+        freeDiameter[d.second] = d.first;
+    }
+}
+
+
+long long GasNetwork::calculateMaxFlow(int source, int sink,
+                                       const ScenarioOverlay* scenario) const {
+    // autre composante ou puits inatteignable : débit nul, sans matrice
+    if (provablyDisconnected(source, sink, scenario)) return 0;
+
+    // réseau découpé : régions utiles seulement
+    std::shared_ptr<const RegionPartition> regions = scenario ? nullptr : partition();
+    if (regions && regions->regionIndexOf(source) >= 0 && regions->regionIndexOf(sink) >= 0)
+        return regions->calculateMaxFlow(source, sink);
 
-long long GasNetwork::calculateMaxFlow(int source, int sink) const {
     // --------- 1️⃣  collecte de tous les nœuds ----------
     std::set<int> nodes{source, sink};
-    for (const auto& kv : graph) {
-        nodes.insert(kv.first);
-        for (const Edge& e : kv.second) nodes.insert(e.to);
-    }
+    forEachSource(graph, scenario, [&](int from) {
+        nodes.insert(from);
+        forEachEdge(graph, scenario, from, [&](const Edge& e) { nodes.insert(e.to); });
+    });
     if (!nodes.count(source) || !nodes.count(sink)) {
         std::cout << "Source or sink not present in the network.\n";
         return 0;
@@ -215,13 +637,13 @@ long long GasNetwork::calculateMaxFlow(int source, int sink) const {
         std::vector<long long>(n, 0));
 
     // --------- 3️⃣  remplissage de la matrice ----------
-    for (const auto& kv : graph) {
-        int u = idx.at(kv.first);
-        for (const Edge& e : kv.second) {
+    forEachSource(graph, scenario, [&](int from) {
+        int u = idx.at(from);
+        forEachEdge(graph, scenario, from, [&](const Edge& e) {
             int v = idx.at(e.to);
             cap[u][v] += e.capacity;                 // somme des capacités multiples
-        }
-    }
+        });
+    });
 
     int s = idx.at(source);
     int t = idx.at(sink);
@@ -266,19 +688,35 @@ long long GasNetwork::calculateMaxFlow(int source, int sink) const {
    (marqué const)
 ======================================================================*/
 std::vector<int> GasNetwork::findShortestPath(int source, int sink,
-                                    const std::unordered_map<int, Pipe>& /*pipes*/) const {
+                                    const std::unordered_map<int, Pipe>& /*pipes*/,
+                                    const ScenarioOverlay* scenario) const {
     using Weight = float;
     const Weight INF = std::numeric_limits<Weight>::infinity();
 
+    // aucun chemin, même par des tuyaux en réparation : Dijkstra inutile
+    if (provablyDisconnected(source, sink, scenario)) {
+        std::cout << "No path found from " << source << " to " << sink << ".\n";
+        return {};
+    }
+
+    // réseau découpé : chemin recousu entre les régions
+    std::shared_ptr<const RegionPartition> regions = scenario ? nullptr : partition();
+    if (regions && regions->regionIndexOf(source) >= 0 && regions->regionIndexOf(sink) >= 0) {
+        std::vector<int> path = regions->findShortestPath(source, sink);
+        if (path.empty())
+            std::cout << "No path found from " << source << " to " << sink << ".\n";
+        return path;
+    }
+
     // --------- distances initiales ----------
     std::unordered_map<int,Weight> dist;
     std::unordered_map<int,int>    parent;
-    for (const auto& kv : graph) {
-        dist[kv.first] = INF; parent[kv.first] = -1;
-        for (const Edge& e : kv.second) {
+    forEachSource(graph, scenario, [&](int from) {
+        dist[from] = INF; parent[from] = -1;
+        forEachEdge(graph, scenario, from, [&](const Edge& e) {
             dist[e.to] = INF; parent[e.to] = -1;
-        }
-    }
+        });
+    });
     if (!dist.count(source) || !dist.count(sink)) {
         std::cout << "Source or sink not present in the network.\n";
         return {};
@@ -299,10 +737,8 @@ std::vector<int> GasNetwork::findShortestPath(int source, int sink,
         if (d != dist[u]) continue;                     // entrée périmée
         if (u == sink) break;                            // arrivé
 
-        auto it = graph.find(u);
-        if (it == graph.end()) continue;
-        for (const Edge& e : it->second) {
-            if (std::isinf(e.weight)) continue;           // tuyau en réparation
+        forEachEdge(graph, scenario, u, [&](const Edge& e) {
+            if (std::isinf(e.weight)) return;             // tuyau en réparation
             int v = e.to;
             Weight nd = d + e.weight;
             if (nd < dist[v]) {
@@ -310,7 +746,7 @@ std::vector<int> GasNetwork::findShortestPath(int source, int sink,
                 parent[v] = u;
                 pq.emplace(nd, v);
             }
-        }
+        });
     }
 
     if (dist[sink] == INF) {
@@ -3,8 +3,24 @@
 #include <vector>
 #include <queue>
 #include <limits>
+#include <map>
+#include <set>
+#include <cstdint>
+#include <memory>
 #include "Pipe.h"
 #include "KC.h"
+#include "DataFile.h"      // ConnectionRecord
+#include "ReachabilityIndex.h"
+#include "ComponentIndex.h"
+
+class ScenarioOverlay;     // scénario « et si… » (ScenarioOverlay.h)
+class GraphSnapshot;       // version figée pour les lecteurs (GraphSnapshot.h)
+class RegionPartition;     // découpage en régions (RegionPartition.h)
+
+// Registre des tuyaux : la map possédée par l'appelant (main, Replay…).
+// GasNetwork n'en garde qu'une référence ; une arête désigne son tuyau
+// par son ID et ne recopie que capacité / poids, rafraîchis sur notification.
+typedef std::unordered_map<int, Pipe> PipeRegistry;
 
 class GasNetwork {
 public:
@@ -20,12 +36,70 @@ public:
         float weight;            // longueur du tuyau ou +inf si en réparation
     };
 
+    // Arête refusée par addConnections : indice dans la liste + motif
+    enum class RejectReason { Duplicate, UnknownPipe, Cycle };
+    struct RejectedConnection {
+        std::size_t  index;
+        RejectReason reason;
+    };
+
 private:
     /* -------------------------------------------------------------
        Données internes (toujours privées)
        ------------------------------------------------------------- */
     std::unordered_map<int, std::vector<Edge>> graph;   // graphe orienté
-    std::unordered_map<int, Pipe>                pipes;   // toutes les tuyaux connus
+    const PipeRegistry*                          pipes;   // registre partagé (non possédé)
+    std::unordered_map<int, std::vector<int>>    pipeSources; // pipe_id → KC sources de ses arêtes
+
+    // Tuyaux libres (dans le registre, sans arête) rangés par diamètre :
+    // diamètres disponibles et plus petit ID libre sans parcourir le registre
+    std::map<int, std::set<int>>                 freePipes;   // diamètre → IDs libres
+    std::unordered_map<int, int>                 freeDiameter; // pipe_id → seau occupé
+
+    // Incrémenté une fois par modification (arêtes, capacités, tuyaux libres) :
+    // un cache dérivé du graphe est périmé dès que la version a changé
+    std::uint64_t                                version = 0;
+    std::uint64_t                                topologyVersion = 0;  // arêtes seulement
+
+    // Dernière version publiée : lue par std::atomic_load depuis les autres
+    // threads, remplacée par std::atomic_store dans publish()
+    std::shared_ptr<const GraphSnapshot>         published;
+    std::uint64_t                                publishedTopology = 0;
+
+    // Atteignabilité entre KC (test de cycle d'addConnection, canReach),
+    // tenue à jour arête par arête ; après un gros lot, reconstruite par le
+    // thread écrivain à la première question ou au publish() suivant
+    // (plusieurs lots de suite : une seule reconstruction). Les analyses
+    // const ne font que la lire, et s'en passent tant qu'elle est périmée.
+    ReachabilityIndex                            reachability;
+    bool                                         reachabilityStale = false;
+
+    // Composantes faiblement connexes : union à chaque arête ajoutée,
+    // reconstruction (thread écrivain) à la première question ou au
+    // publish() qui suit un retrait ou un gros lot ; lue seulement par les
+    // analyses const, qui s'en passent tant qu'elle est périmée
+    ComponentIndex                               componentIndex;
+    bool                                         componentsStale = false;
+
+    // Régions (ID de KC → numéro ; vide : pas de découpage) et découpage,
+    // construit par le thread écrivain (setRegions, publish) : les analyses
+    // const ne font que le lire
+    std::unordered_map<int, int>                 regionOf;
+    std::shared_ptr<const RegionPartition>       regionPartition;
+
+    // capacité / poids de l'arête recalculés depuis le registre
+    void refreshEdge(Edge& e) const;
+    void addFree(int pipe_id, int diameter);
+    void removeFree(int pipe_id);
+    bool applyPipeChange(int pipe_id);           // true si le réseau a changé
+    // découpage de la version courante (current : version publiée si elle
+    // est à jour, sinon nullptr)
+    void rebuildPartition(std::shared_ptr<const GraphSnapshot> current);
+    ReachabilityIndex& currentReachability();
+    const ComponentIndex& currentComponents();
+    // source et puits présents, mais aucun chemin possible (réseau réel ou
+    // scénario qui ne change que des états de tuyaux)
+    bool provablyDisconnected(int source, int sink, const ScenarioOverlay* scenario) const;
 
     /* -------------------------------------------------------------
        Fonction auxiliaire de détection de cycles (DFS)
@@ -35,21 +109,44 @@ private:
                     const std::unordered_map<int,std::vector<Edge>>& g) const;
 
 public:
-    GasNetwork();
+    explicit GasNetwork(const PipeRegistry& registry);
 
     /* -----------------------------------------------------------------
        Opérations de base
        ----------------------------------------------------------------- */
     bool addConnection(int from, int to, int pipe_id);   // crée une arête
+
+    // Import en bloc : mêmes règles qu'une suite d'addConnection dans l'ordre
+    // de la liste (doublon, tuyau inconnu, cycle), mais doublons testés par
+    // hachage et acyclicité par un seul tri de Kahn sur tout le lot.
+    std::vector<RejectedConnection> addConnections(const std::vector<ConnectionRecord>& batch);
     bool connectionExists(int from, int to) const;
     bool isPipeUsed(int pipe_id) const;
     bool isPipeInNetwork(int pipe_id) const;
     void removeConnectionByPipe(int pipe_id);
     bool canDeleteKC(int kc_id) const;
     bool hasCycle() const;
+    // Un chemin d'arêtes mène-t-il de from à to ? (tuyaux en réparation
+    // compris ; from == to : vrai). Sans parcours en général
+    // (ReachabilityIndex). Non const : peut reconstruire l'index et écrit
+    // dans ses tampons de parcours, donc réservé au thread écrivain ; les
+    // autres threads passent par snapshot().
+    bool canReach(int from, int to) { return currentReachability().reaches(from, to); }
+
+    // Composantes faiblement connexes (sens des arêtes ignoré) : KC
+    // présentes dans le graphe, IDs triés, composantes rangées par plus
+    // petit ID. Découpage naturel pour traiter chaque sous-réseau à part.
+    // Non const (reconstruction possible) : thread écrivain, comme canReach.
+    bool                          sameComponent(int a, int b);
+    std::size_t                   componentCount();
+    std::vector<std::vector<int>> components();
     bool isEmpty() const;
     void displayConnections() const;
-    std::vector<int> topologicalSort(const std::unordered_map<int, KC>& companies) const;
+    // Les analyses acceptent un scénario (nullptr = réseau réel)
+    // Ordre niveau par niveau (GraphSnapshot::computeLevels) ; vide si le
+    // graphe a un cycle ou une arête vers une KC absente de companies
+    std::vector<int> topologicalSort(const std::unordered_map<int, KC>& companies,
+                                     const ScenarioOverlay* scenario = nullptr) const;
 
     /* -----------------------------------------------------------------
        Accesseurs publics supplémentaires
@@ -57,18 +154,57 @@ public:
     // Accès en lecture au graphe (necessaire pour les affichages externes)
     const std::unordered_map<int, std::vector<Edge>>& getGraph() const { return graph; }
 
-    // Enregistrement d’un tuyau dès sa création (appelé depuis le menu principal)
-    void registerPipe(int pipe_id, const Pipe& pipe);
+    // Notification : le tuyau a été ajouté, modifié ou retiré du registre.
+    // Seules les arêtes de ce tuyau sont relues (index pipe_id → sources).
+    void updatePipeInNetwork(int pipe_id);
+
+    // Même notification pour un lot de tuyaux : une seule passe par l'index
+    // et une seule nouvelle version pour tout le lot
+    void updatePipesInNetwork(const std::vector<int>& pipe_ids);
+
+    std::uint64_t getVersion() const { return version; }
+
+    // Lecteurs concurrents : un seul thread écrivain modifie le réseau puis
+    // appelle publish() ; les autres threads n'utilisent que snapshot(), qui
+    // ne bloque jamais sur une écriture et rend une version cohérente
+    // (nullptr avant le premier publish). publish() ne reconstruit rien si
+    // la version n'a pas changé, et réutilise la topologie si seules les
+    // capacités ont bougé. Il remet aussi à jour les index périmés, que les
+    // analyses const lisent sans jamais les modifier.
+    void publish();
+    std::shared_ptr<const GraphSnapshot> snapshot() const;
+
+    // Relit toutes les arêtes et les tuyaux libres (après un chargement
+    // qui remplace le registre)
+    void refreshPipes();
+
+    // Tuyaux libres : diamètres ayant au moins un tuyau libre (croissants),
+    // nombre de tuyaux libres d'un diamètre, plus petit ID libre (-1 si aucun)
+    std::vector<int> availableDiameters() const;
+    std::size_t      unusedPipeCount(int diameter) const;
+    int              firstUnusedPipe(int diameter) const;
 
-    // Mise à jour d’un tuyau déjà présent dans le réseau (ex. changement de répar.)
-    void updatePipeInNetwork(int pipe_id, const Pipe& pipe);
+    // Découpage en régions : réseaux régionaux reliés par quelques KC
+    // d'interconnexion (voir RegionPartition). Sur le réseau réel (sans
+    // scénario), calculateMaxFlow et findShortestPath passent alors par
+    // le découpage : seules les régions utiles sont parcourues. Une carte
+    // vide supprime le découpage. setRegions() le construit aussitôt, et
+    // publish() le reconstruit (tables comprises) après une modification.
+    void setRegions(const std::unordered_map<int, int>& regionOfKc);
+    bool hasRegions() const { return !regionOf.empty(); }
+    // nullptr sans régions, ou si le réseau a changé depuis le dernier
+    // setRegions() / publish() : les analyses parcourent alors tout le
+    // graphe. Ne modifie rien, appelable depuis plusieurs threads.
+    std::shared_ptr<const RegionPartition> partition() const;
 
     // Calcul du débit maximal (const – ne modifie rien)
-    long long calculateMaxFlow(int source, int sink) const;
+    long long calculateMaxFlow(int source, int sink,
+                               const ScenarioOverlay* scenario = nullptr) const;
 
     // Recherche du plus court chemin (Dijkstra – const)
     std::vector<int> findShortestPath(int source, int sink,
-                                      const std::unordered_map<int, Pipe>& pipes) const;
+                                      const std::unordered_map<int, Pipe>& pipes,
+                                      const ScenarioOverlay* scenario = nullptr) const;
 
     // Affichage complet (max‑flow + shortest path) – const
     void displayFlowAnalysis(int source, int sink,
@@ -0,0 +1,134 @@
+// GenerateNetwork.cpp – génère un réseau synthétique reproductible :
+// un fichier de données (format de saveToFile) + une liste de connexions.
+//
+//   g++ -std=c++11 -O2 -o gennet GenerateNetwork.cpp NetworkGenerator.cpp
+//       Pipe.cpp KC.cpp GasNetwork.cpp ReachabilityIndex.cpp ComponentIndex.cpp RegionPartition.cpp Logger.cpp EventLog.cpp DataFile.cpp PipeStore.cpp CompanyIndex.cpp TrigramIndex.cpp StringPool.cpp IdAllocator.cpp ScenarioOverlay.cpp GraphSnapshot.cpp AnalysisTask.cpp TaskScheduler.cpp DiskGraph.cpp PagedFile.cpp -pthread
+//   gennet --companies 100000 --topology mesh --seed 7 -o big.txt -c big_connections.txt -g big.graph
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <sstream>
+#include "NetworkGenerator.h"
+#include "DataFile.h"
+
+namespace {
+
+void usage() {
+    std::cerr <<
+        "Usage: gennet [options]\n"
+        "  --seed N                 graine (defaut 1)\n"
+        "  --companies N            nombre de KC (defaut 1000)\n"
+        "  --pipes N                nombre de pipes, au moins une par connexion\n"
+        "                           (defaut : connexions + spare)\n"
+        "  --spare F                part de pipes libres en plus (defaut 0.1)\n"
+        "  --width N | --depth N    KC par niveau / nombre de niveaux du DAG\n"
+        "  --topology tree|mesh     arbre (1 parent) ou maillage (fan-in parents)\n"
+        "  --fan-in N --span N      maillage : parents par KC, niveaux candidats\n"
+        "  --regions N              sous-reseaux regionaux independants\n"
+        "  --interconnects N        connexions entre deux regions successives\n"
+        "  --diameters 500:4,700:3,1000:2,1400:1   melange de diametres (poids)\n"
+        "  --length uniform:MIN:MAX | lognormal:MU:SIGMA | fixed:V\n"
+        "  --repair-ratio F         part de pipes en reparation (defaut 0.05)\n"
+        "  -o FILE                  fichier de donnees (defaut generated.txt)\n"
+        "  -c FILE                  liste de connexions (defaut generated_connections.txt)\n"
+        "  -g FILE                  reseau sur disque (DiskGraph), en plus\n";
+}
+
+bool parseDiameters(const std::string& spec, GeneratorParams& p) {
+    p.diameterMix.clear();
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        std::size_t colon = item.find(':');
+        int d = std::atoi(item.substr(0, colon).c_str());
+        double w = colon == std::string::npos ? 1.0 : std::atof(item.substr(colon + 1).c_str());
+        if (d != 500 && d != 700 && d != 1000 && d != 1400) return false;
+        if (w > 0) p.diameterMix.push_back(std::make_pair(d, w));
+    }
+    return !p.diameterMix.empty();
+}
+
+bool parseLength(const std::string& spec, GeneratorParams& p) {
+    std::stringstream ss(spec);
+    std::string kind, a, b;
+    std::getline(ss, kind, ':');
+    std::getline(ss, a, ':');
+    std::getline(ss, b, ':');
+    if (kind == "uniform" && !a.empty() && !b.empty())
+        p.lengthDistribution = GeneratorParams::LengthDistribution::Uniform;
+    else if (kind == "lognormal" && !a.empty() && !b.empty())
+        p.lengthDistribution = GeneratorParams::LengthDistribution::LogNormal;
+    else if (kind == "fixed" && !a.empty())
+        p.lengthDistribution = GeneratorParams::LengthDistribution::Fixed;
+    else
+        return false;
+    p.lengthA = std::atof(a.c_str());
+    p.lengthB = b.empty() ? 0.0 : std::atof(b.c_str());
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorParams p;
+    std::string dataFile = "generated.txt";
+    std::string connFile = "generated_connections.txt";
+    std::string diskFile;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) { usage(); return 2; }
+        std::string val = argv[++i];
+        if      (arg == "--seed")          p.seed = std::strtoull(val.c_str(), nullptr, 10);
+        else if (arg == "--companies")     p.companies = std::atoi(val.c_str());
+        else if (arg == "--pipes")         p.pipes = std::atoi(val.c_str());
+        else if (arg == "--spare")         p.sparePipes = std::atof(val.c_str());
+        else if (arg == "--width")         p.width = std::atoi(val.c_str());
+        else if (arg == "--depth")         p.depth = std::atoi(val.c_str());
+        else if (arg == "--fan-in")        p.fanIn = std::atoi(val.c_str());
+        else if (arg == "--span")          p.span = std::atoi(val.c_str());
+        else if (arg == "--regions")       p.regions = std::atoi(val.c_str());
+        else if (arg == "--interconnects") p.interconnects = std::atoi(val.c_str());
+        else if (arg == "--repair-ratio")  p.repairRatio = std::atof(val.c_str());
+        else if (arg == "-o")              dataFile = val;
+        else if (arg == "-c")              connFile = val;
+        else if (arg == "-g")              diskFile = val;
+        else if (arg == "--topology" && (val == "tree" || val == "mesh"))
+            p.topology = val == "tree" ? GeneratorParams::Topology::Tree
+                                       : GeneratorParams::Topology::Mesh;
+        else if (arg == "--diameters" && parseDiameters(val, p)) {}
+        else if (arg == "--length" && parseLength(val, p)) {}
+        else { usage(); return 2; }
+    }
+
+    NetworkGenerator gen(p);
+    if (gen.droppedConnections() > 0) {               // réseau tronqué : refusé plutôt que muet
+        std::cerr << "--pipes " << p.pipes << " is below the "
+                  << gen.connections().size() + gen.droppedConnections()
+                  << " connections of this topology (" << gen.droppedConnections()
+                  << " would be dropped); raise --pipes or omit it\n";
+        return 2;
+    }
+    if (!gen.writeDataFile(dataFile)) {
+        std::cerr << "Unable to write " << dataFile << '\n';
+        return 1;
+    }
+    if (!saveConnections(gen.connections(), connFile)) {
+        std::cerr << "Unable to write " << connFile << '\n';
+        return 1;
+    }
+    std::cout << "Generated " << gen.companyCount() << " companies, "
+              << gen.pipeCount() << " pipes, "
+              << gen.connections().size() << " connections (depth "
+              << gen.depth() << ", seed " << p.seed << ")\n"
+              << "  data        : " << dataFile << '\n'
+              << "  connections : " << connFile << '\n';
+    if (!diskFile.empty()) {
+        if (!gen.writeDiskGraph(diskFile)) {
+            std::cerr << "Unable to write " << diskFile << '\n';
+            return 1;
+        }
+        std::cout << "  disk graph  : " << diskFile << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+#include "GraphSnapshot.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "AnalysisTask.h"
+#include "TaskScheduler.h"
+
+namespace {
+const std::size_t PARALLEL_LEVEL = 2048;      // KC : en dessous, niveau traité sur place
+const std::size_t LEVEL_GRAIN    = 512;
+
+// pull(v) pour chaque KC des niveaux firstLevel et suivants, un niveau après
+// l'autre ; v ne lit que des KC de niveaux déjà traités
+template<typename Pull>
+void byLevels(const GraphSnapshot::Levels& l, std::size_t firstLevel, Pull pull) {
+    for (std::size_t k = firstLevel; k < l.levelCount(); ++k) {
+        std::size_t begin = l.levelStart[k], end = l.levelStart[k + 1];
+        if (end - begin < PARALLEL_LEVEL) {
+            for (std::size_t i = begin; i < end; ++i) pull(l.order[i]);
+            continue;
+        }
+        TaskScheduler::shared().parallelFor(begin, end, LEVEL_GRAIN, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) pull(l.order[i]);
+        });
+    }
+}
+}
+
+/*======================================================================
+   CONSTRUCTION – CSR depuis les listes d'adjacence
+======================================================================*/
+GraphSnapshot::GraphSnapshot(const Graph& graph, std::uint64_t version,
+                             std::shared_ptr<const Topology> topology)
+    : graphVersion(version), topo(topology) {
+    if (!topo) {
+        std::shared_ptr<Topology> t = std::make_shared<Topology>();
+        std::size_t edges = 0;
+        for (const auto& kv : graph) {
+            t->kcIds.push_back(kv.first);
+            for (const GasNetwork::Edge& e : kv.second) t->kcIds.push_back(e.to);
+            edges += kv.second.size();
+        }
+        std::sort(t->kcIds.begin(), t->kcIds.end());
+        t->kcIds.erase(std::unique(t->kcIds.begin(), t->kcIds.end()), t->kcIds.end());
+
+        const int n = static_cast<int>(t->kcIds.size());
+        t->offsets.assign(n + 1, 0);
+        t->targets.reserve(edges);
+        t->pipeIds.reserve(edges);
+        topo = t;                                  // indexOf lit kcIds
+        for (int i = 0; i < n; ++i) {
+            t->offsets[i] = static_cast<int>(t->targets.size());
+            auto it = graph.find(t->kcIds[i]);
+            if (it == graph.end()) continue;
+            for (const GasNetwork::Edge& e : it->second) {
+                t->targets.push_back(indexOf(e.to));
+                t->pipeIds.push_back(e.pipe_id);
+            }
+        }
+        t->offsets[n] = static_cast<int>(t->targets.size());
+    }
+
+    // capacités / poids dans l'ordre CSR (même ordre d'arêtes que le graphe)
+    capacities.resize(topo->targets.size());
+    weights.resize(topo->targets.size());
+    const int n = static_cast<int>(topo->kcIds.size());
+    for (int i = 0; i < n; ++i) {
+        auto it = graph.find(topo->kcIds[i]);
+        if (it == graph.end()) continue;
+        int e = topo->offsets[i];
+        for (const GasNetwork::Edge& edge : it->second) {
+            capacities[e] = edge.capacity;
+            weights[e]    = edge.weight;
+            ++e;
+        }
+    }
+}
+
+int GraphSnapshot::indexOf(int kc_id) const {
+    auto it = std::lower_bound(topo->kcIds.begin(), topo->kcIds.end(), kc_id);
+    if (it == topo->kcIds.end() || *it != kc_id) return -1;
+    return static_cast<int>(it - topo->kcIds.begin());
+}
+
+/*======================================================================
+   ANALYSES – tâches (AnalysisTask.h) menées jusqu'au bout
+======================================================================*/
+long long GraphSnapshot::calculateMaxFlow(int source, int sink) const {
+    MaxFlowTask task(*this, source, sink);
+    task.run();
+    return task.flow();
+}
+
+std::vector<int> GraphSnapshot::findShortestPath(int source, int sink) const {
+    ShortestPathTask task(*this, source, sink);
+    task.run();
+    return task.path();
+}
+
+/*======================================================================
+   NIVEAUX – Kahn synchrone sur tableaux plats
+======================================================================*/
+bool GraphSnapshot::computeLevels(int n, const std::vector<int>& offsets,
+                                  const std::vector<int>& targets, Levels& out) {
+    std::vector<int> indegree(n, 0);
+    for (int v : targets) ++indegree[v];
+
+    out.order.clear();
+    out.order.reserve(n);
+    out.levelOf.assign(n, -1);
+    out.levelStart.assign(1, 0);
+    for (int i = 0; i < n; ++i)
+        if (indegree[i] == 0) { out.order.push_back(i); out.levelOf[i] = 0; }
+
+    // niveau k = order[begin, end) ; ses successeurs libérés forment k + 1
+    std::size_t begin = 0;
+    for (int level = 1; begin < out.order.size(); ++level) {
+        std::size_t end = out.order.size();
+        out.levelStart.push_back(static_cast<int>(end));
+        for (std::size_t k = begin; k < end; ++k) {
+            int u = out.order[k];
+            for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+                int v = targets[e];
+                if (--indegree[v] == 0) { out.order.push_back(v); out.levelOf[v] = level; }
+            }
+        }
+        begin = end;
+    }
+    out.acyclic = out.order.size() == static_cast<std::size_t>(n);
+    return out.acyclic;
+}
+
+const GraphSnapshot::Levels& GraphSnapshot::levels() const {
+    std::call_once(topo->levelsOnce, [this] {
+        const Topology& t = *topo;
+        const int n = static_cast<int>(nodeCount());
+        std::unique_ptr<Levels> l(new Levels());
+        computeLevels(n, t.offsets, t.targets, *l);
+
+        // arêtes entrantes : CSR inverse par comptage
+        l->inOffsets.assign(n + 1, 0);
+        for (int v : t.targets) ++l->inOffsets[v + 1];
+        for (int i = 0; i < n; ++i) l->inOffsets[i + 1] += l->inOffsets[i];
+        l->inEdges.resize(t.targets.size());
+        l->inSources.resize(t.targets.size());
+        std::vector<int> fill(l->inOffsets.begin(), l->inOffsets.end() - 1);
+        for (int u = 0; u < n; ++u)
+            for (int e = t.offsets[u]; e < t.offsets[u + 1]; ++e) {
+                int k = fill[t.targets[e]]++;
+                l->inEdges[k]   = e;
+                l->inSources[k] = u;
+            }
+        t.levels = std::move(l);
+    });
+    return *topo->levels;
+}
+
+/*======================================================================
+   COMPOSANTES – union-find sur les indices denses
+======================================================================*/
+const std::vector<int>& GraphSnapshot::components() const {
+    std::call_once(topo->componentsOnce, [this] {
+        const Topology& t = *topo;
+        const int n = static_cast<int>(nodeCount());
+        std::vector<int> parent(n);
+        for (int i = 0; i < n; ++i) parent[i] = i;
+        auto find = [&parent](int x) {
+            while (parent[x] != x) { parent[x] = parent[parent[x]]; x = parent[x]; }
+            return x;
+        };
+        for (int u = 0; u < n; ++u)
+            for (int e = t.offsets[u]; e < t.offsets[u + 1]; ++e) {
+                int a = find(u), b = find(t.targets[e]);
+                if (a != b) parent[std::max(a, b)] = std::min(a, b);   // racine : plus petit indice
+            }
+        t.components.resize(n);
+        int next = 0;
+        for (int i = 0; i < n; ++i) {                  // indices croissants = IDs croissants
+            int r = find(i);
+            t.components[i] = r == i ? next++ : t.components[r];
+        }
+    });
+    return topo->components;
+}
+
+/*======================================================================
+   CALCULS PAR NIVEAUX – chaque KC tire de ses arêtes entrantes
+======================================================================*/
+std::vector<float> GraphSnapshot::distancesFrom(int source) const {
+    const int s = indexOf(source);
+    if (s < 0) return {};
+    const Levels& l = levels();
+    if (!l.acyclic) return {};
+
+    std::vector<float> dist(nodeCount(), std::numeric_limits<float>::infinity());
+    dist[s] = 0.0f;
+    // les KC des niveaux <= celui de la source sont inaccessibles
+    byLevels(l, l.levelOf[s] + 1, [&](int v) {
+        float best = dist[v];
+        for (int k = l.inOffsets[v]; k < l.inOffsets[v + 1]; ++k) {
+            float w = weights[l.inEdges[k]];
+            if (std::isinf(w)) continue;                    // tuyau en réparation
+            float d = dist[l.inSources[k]] + w;
+            if (d < best) best = d;
+        }
+        dist[v] = best;
+    });
+    return dist;
+}
+
+std::vector<GraphSnapshot::FlowType> GraphSnapshot::widestFrom(int source) const {
+    const int s = indexOf(source);
+    if (s < 0) return {};
+    const Levels& l = levels();
+    if (!l.acyclic) return {};
+
+    std::vector<FlowType> width(nodeCount(), 0);
+    width[s] = std::numeric_limits<FlowType>::max();
+    byLevels(l, l.levelOf[s] + 1, [&](int v) {
+        FlowType best = 0;
+        for (int k = l.inOffsets[v]; k < l.inOffsets[v + 1]; ++k)
+            best = std::max(best, std::min(width[l.inSources[k]], capacities[l.inEdges[k]]));
+        width[v] = best;
+    });
+    return width;
+}
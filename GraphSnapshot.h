@@ -0,0 +1,122 @@
+// GraphSnapshot.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "GasNetwork.h"
+
+// ---------------------------------------------------------------------
+//  Version figée du graphe, lisible depuis n'importe quel thread.
+//
+//  GasNetwork::publish() (thread écrivain) construit une GraphSnapshot
+//  quand la version du réseau a changé et la publie par un shared_ptr
+//  échangé atomiquement ; GasNetwork::snapshot() la récupère sans
+//  attendre l'écrivain. Une requête garde son shared_ptr du début à la
+//  fin : elle voit une seule version même si le réseau est modifié et
+//  republié pendant le calcul. Une ancienne version est libérée quand
+//  son dernier lecteur la lâche (le compteur du shared_ptr joue le rôle
+//  des époques).
+//
+//  Stockage CSR : KC triés par ID (indices denses), arêtes de chaque KC
+//  contiguës. La topologie (KC, cibles, tuyaux) est partagée entre les
+//  versions qui ne diffèrent que par les capacités / poids : republier
+//  après un changement d'état de tuyaux ne recopie que ces deux colonnes.
+//
+//  Niveaux topologiques (levels()) : les KC d'un même niveau ne dépendent
+//  pas les unes des autres, toutes leurs arêtes entrantes viennent des
+//  niveaux précédents. Les calculs sur tout le DAG (distancesFrom,
+//  widestFrom) traitent un niveau après l'autre, chaque grand niveau en
+//  parallèle sur le TaskScheduler partagé : chaque KC tire ses valeurs de
+//  ses arêtes entrantes, sans écriture concurrente. Calculés à la première
+//  demande, une fois par topologie.
+//
+//  Les requêtes n'affichent rien : KC absent → résultat vide / 0.
+// ---------------------------------------------------------------------
+class GraphSnapshot {
+public:
+    typedef GasNetwork::Edge::FlowType FlowType;
+    typedef std::unordered_map<int, std::vector<GasNetwork::Edge>> Graph;
+
+    // Décomposition en niveaux (Kahn synchrone) et arêtes entrantes
+    struct Levels {
+        bool             acyclic = true;   // false : order ne couvre pas tout le graphe
+        std::vector<int> order;            // indices denses, niveau par niveau
+        std::vector<int> levelStart;       // niveau k : order[levelStart[k], levelStart[k+1])
+        std::vector<int> levelOf;          // indice dense → niveau (-1 : sur un cycle)
+        std::vector<int> inOffsets;        // arêtes entrantes de i : [inOffsets[i], inOffsets[i+1])
+        std::vector<int> inEdges;          // indice CSR de l'arête entrante
+        std::vector<int> inSources;        // indice dense de son origine
+
+        std::size_t levelCount() const { return levelStart.empty() ? 0 : levelStart.size() - 1; }
+    };
+
+    // KC, décalages et cibles : ne change qu'avec les arêtes
+    struct Topology {
+        std::vector<int> kcIds;        // indice dense → ID de KC (croissant)
+        std::vector<int> offsets;      // arêtes de i : [offsets[i], offsets[i+1])
+        std::vector<int> targets;      // indice dense de la destination
+        std::vector<int> pipeIds;
+
+        mutable std::once_flag          levelsOnce;    // levels() : à la première demande
+        mutable std::unique_ptr<Levels> levels;
+        mutable std::once_flag          componentsOnce;
+        mutable std::vector<int>        components;
+    };
+
+    // Niveaux d'un graphe CSR quelconque à n nœuds (sans arêtes entrantes) ;
+    // false si le graphe a un cycle
+    static bool computeLevels(int n, const std::vector<int>& offsets,
+                              const std::vector<int>& targets, Levels& out);
+
+private:
+    std::uint64_t                   graphVersion;
+    std::shared_ptr<const Topology> topo;
+    std::vector<FlowType>           capacities;     // par arête, ordre CSR
+    std::vector<float>              weights;
+
+public:
+    // topology : celle d'une version précédente encore valable, ou nullptr
+    // pour la reconstruire depuis le graphe
+    GraphSnapshot(const Graph& graph, std::uint64_t version,
+                  std::shared_ptr<const Topology> topology = nullptr);
+
+    std::uint64_t version() const { return graphVersion; }
+    const std::shared_ptr<const Topology>& topology() const { return topo; }
+
+    std::size_t nodeCount() const { return topo->kcIds.size(); }
+    std::size_t edgeCount() const { return topo->targets.size(); }
+    int         indexOf(int kc_id) const;             // -1 si absent
+    int         kcId(int index) const { return topo->kcIds[index]; }
+
+    // arêtes du nœud dense i : [edgeBegin(i), edgeEnd(i))
+    int      edgeBegin(int i) const      { return topo->offsets[i]; }
+    int      edgeEnd(int i) const        { return topo->offsets[i + 1]; }
+    int      target(int e) const         { return topo->targets[e]; }
+    int      pipeId(int e) const         { return topo->pipeIds[e]; }
+    FlowType capacity(int e) const       { return capacities[e]; }
+    float    weight(int e) const         { return weights[e]; }
+
+    // Mêmes résultats que GasNetwork sur la version figée ; versions
+    // interruptibles (échéance, annulation) : MaxFlowTask / ShortestPathTask
+    long long        calculateMaxFlow(int source, int sink) const;
+    std::vector<int> findShortestPath(int source, int sink) const;   // IDs de KC
+
+    const Levels& levels() const;
+
+    // Composante faiblement connexe de chaque indice dense (numérotées 0, 1,
+    // … dans l'ordre des IDs) ; à la première demande, une fois par
+    // topologie. Deux KC de composantes différentes : aucun chemin, les
+    // analyses s'arrêtent sans rien construire.
+    const std::vector<int>& components() const;
+    bool connected(int i, int j) const { return components()[i] == components()[j]; }
+
+    // Depuis une KC vers toutes les autres, par niveaux (indices denses ;
+    // vide si la KC est absente ou le graphe cyclique) : longueur du plus
+    // court chemin (+inf si inaccessible) et capacité du goulot du chemin
+    // le plus large (0 si inaccessible, maximum de FlowType pour la source)
+    std::vector<float>    distancesFrom(int source) const;
+    std::vector<FlowType> widestFrom(int source) const;
+};
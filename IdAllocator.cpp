@@ -0,0 +1,119 @@
+#include "IdAllocator.h"
+#include <algorithm>
+
+namespace {
+const std::uint64_t FULL = ~std::uint64_t(0);
+
+inline unsigned lowestBit(std::uint64_t m) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(m));
+#else
+    unsigned i = 0;
+    while (!(m & 1)) { m >>= 1; ++i; }
+    return i;
+#endif
+}
+}
+
+/*======================================================================
+   MAINTENANCE
+======================================================================*/
+void IdAllocator::clear() {
+    levels.assign(1, std::vector<std::uint64_t>(1, 1));   // ID 0 jamais attribué
+    used = 0;
+}
+
+// Niveaux de résumé recalculés depuis le niveau 0 (O(n / 64))
+void IdAllocator::rebuildSummaries() {
+    levels.resize(1);
+    while (levels.back().size() > 1) {
+        const std::vector<std::uint64_t>& below = levels.back();
+        std::vector<std::uint64_t> above((below.size() + 63) / 64, 0);
+        for (std::size_t w = 0; w < below.size(); ++w)
+            if (below[w] == FULL) above[w / 64] |= std::uint64_t(1) << (w % 64);
+        levels.push_back(above);
+    }
+}
+
+// Capacité doublée au minimum : agrandissements amortis
+void IdAllocator::ensure(int id) {
+    std::size_t words = static_cast<std::size_t>(id) / 64 + 1;
+    if (words <= levels[0].size()) return;
+    levels[0].resize(std::max(words, levels[0].size() * 2), 0);
+    rebuildSummaries();
+}
+
+void IdAllocator::assign(const std::vector<int>& ids) {
+    clear();
+    int maxId = 0;
+    for (int id : ids) maxId = std::max(maxId, id);
+    levels[0].resize(static_cast<std::size_t>(maxId) / 64 + 1, 0);
+    for (int id : ids) {
+        if (id <= 0) continue;
+        std::uint64_t bit = std::uint64_t(1) << (id % 64);
+        if (!(levels[0][id / 64] & bit)) { levels[0][id / 64] |= bit; ++used; }
+    }
+    rebuildSummaries();
+}
+
+void IdAllocator::reserve(int id) {
+    if (id <= 0) return;
+    ensure(id);
+    std::size_t pos = static_cast<std::size_t>(id);
+    std::uint64_t bit = std::uint64_t(1) << (pos % 64);
+    if (levels[0][pos / 64] & bit) return;
+    ++used;
+    // remonte tant que le mot modifié devient plein
+    for (std::size_t k = 0; k < levels.size(); ++k) {
+        std::uint64_t& word = levels[k][pos / 64];
+        word |= std::uint64_t(1) << (pos % 64);
+        if (word != FULL) break;
+        pos /= 64;
+    }
+}
+
+void IdAllocator::release(int id) {
+    if (!contains(id)) return;
+    --used;
+    // remonte tant que le mot modifié était plein
+    std::size_t pos = static_cast<std::size_t>(id);
+    for (std::size_t k = 0; k < levels.size(); ++k) {
+        std::uint64_t& word = levels[k][pos / 64];
+        bool wasFull = word == FULL;
+        word &= ~(std::uint64_t(1) << (pos % 64));
+        if (!wasFull) break;
+        pos /= 64;
+    }
+}
+
+/*======================================================================
+   RECHERCHES
+======================================================================*/
+bool IdAllocator::contains(int id) const {
+    if (id <= 0) return false;
+    std::size_t pos = static_cast<std::size_t>(id);
+    if (pos / 64 >= levels[0].size()) return false;
+    return (levels[0][pos / 64] >> (pos % 64)) & 1;
+}
+
+// Descente depuis le sommet : un bit à 0 désigne un mot non plein en
+// dessous. Un bit de bourrage (au-delà du dernier mot) signifie que tous
+// les mots existants sont pleins : premier ID après la capacité.
+int IdAllocator::nextId() const {
+    const std::size_t capacity = levels[0].size() * 64;
+    std::size_t pos = 0;
+    for (std::size_t k = levels.size(); k-- > 0;) {
+        const std::vector<std::uint64_t>& level = levels[k];
+        if (pos >= level.size()) return static_cast<int>(capacity);
+        std::uint64_t free = ~level[pos];
+        if (!free) return static_cast<int>(capacity);
+        pos = pos * 64 + lowestBit(free);
+    }
+    return static_cast<int>(pos);
+}
+
+int IdAllocator::acquire() {
+    int id = nextId();
+    reserve(id);
+    return id;
+}
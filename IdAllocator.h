@@ -0,0 +1,50 @@
+// IdAllocator.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------
+//  Attribution des IDs (tuyaux, KC) : toujours le plus petit ID libre >= 1.
+//
+//  Bitmap des IDs occupés (niveau 0) surmonté de niveaux de résumé : au
+//  niveau k, le bit i vaut 1 quand le mot i du niveau k-1 est plein. La
+//  recherche du premier ID libre descend les niveaux (log64 n mots lus,
+//  3 niveaux suffisent pour 250 000 IDs) au lieu de tester 1, 2, 3…
+//
+//  L'allocateur doit suivre la table : assign après un chargement,
+//  reserve à l'insertion, release à la suppression.
+// ---------------------------------------------------------------------
+class IdAllocator {
+private:
+    std::vector<std::vector<std::uint64_t>> levels;   // levels[0] : un bit par ID
+    std::size_t used = 0;
+
+    void ensure(int id);                              // agrandit jusqu'à id inclus
+    void rebuildSummaries();
+
+public:
+    IdAllocator() { clear(); }
+
+    template<typename T>
+    explicit IdAllocator(const std::unordered_map<int, T>& objects) { assign(objects); }
+
+    template<typename T>
+    void assign(const std::unordered_map<int, T>& objects) {
+        std::vector<int> ids;
+        ids.reserve(objects.size());
+        for (const auto& kv : objects) ids.push_back(kv.first);
+        assign(ids);
+    }
+    void assign(const std::vector<int>& ids);
+    void clear();
+
+    int  nextId() const;               // plus petit ID libre, sans le réserver
+    int  acquire();                    // nextId() puis reserve()
+    void reserve(int id);              // sans effet si déjà pris ou id <= 0
+    void release(int id);              // sans effet si libre
+
+    bool        contains(int id) const;
+    std::size_t size() const { return used; }
+};
@@ -6,13 +6,11 @@
 #include <string>
 #include <algorithm>
 #include "Logger.h"
+#include "CompanyIndex.h"
+#include "GasNetwork.h"
 
-int addCompany(std::unordered_map<int, KC>& companies) {
-    // compute next id as max existing id + 1
-    int nextCompanyId = 0;
-    for (std::unordered_map<int, KC>::const_iterator it = companies.begin(); it != companies.end(); ++it)
-        if (it->first > nextCompanyId) nextCompanyId = it->first;
-    nextCompanyId++;
+int addCompany(std::unordered_map<int, KC>& companies, IdAllocator& ids) {
+    int nextCompanyId = ids.acquire();
 
     KC c;
     c.input(nextCompanyId);
@@ -22,7 +20,17 @@ int addCompany(std::unordered_map<int, KC>& companies) {
     return nextCompanyId;
 }
 
-void manageCompanies(std::unordered_map<int, KC>& companies) {
+// Non-interactive variant (log replay, batch mode)
+int addCompany(std::unordered_map<int, KC>& companies, IdAllocator& ids, const std::string& name,
+               int workshops, int workshopsInOperation, const std::string& classes) {
+    int nextCompanyId = ids.acquire();
+    companies[nextCompanyId] = KC(nextCompanyId, name, workshops, workshopsInOperation, classes);
+    Logger::logCompanySimple(name, workshops, workshopsInOperation, classes);
+    return nextCompanyId;
+}
+
+void manageCompanies(std::unordered_map<int, KC>& companies, CompanyIndex& index,
+                     const GasNetwork& network) {
     int subchoice;
     std::vector<int> lastSearch;
     do {
@@ -44,38 +52,37 @@ void manageCompanies(std::unordered_map<int, KC>& companies) {
                     int createCompany;
                     std::cin >> createCompany;
                     if (createCompany == 1) {
-                        int newId = addCompany(companies);
-                        (void)newId;
+                        int newId = addCompany(companies, index.allocator());
+                        index.upsert(companies[newId]);
                     }
                     break;
                 }
                 
-                std::cout << "Filter by:\n1. Name\n2. % unused workshops\nYour choice: ";
+                std::cout << "Filter by:\n1. Name\n2. % unused workshops\n3. Name starts with\n"
+                             "4. Name contains\n5. Classes contain\nYour choice: ";
                 int filter; std::cin >> filter;
                 if (filter == 1) {
                     std::string name;
                     std::cout << "Enter name: ";
                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                     getline(std::cin, name);
-                    lastSearch.clear();
-                    for (std::unordered_map<int, KC>::const_iterator it = companies.begin(); it != companies.end(); ++it) {
-                        if (it->second.getName() == name) {
-                            it->second.display();
-                            lastSearch.push_back(it->first);
-                        }
-                    }
+                    lastSearch = index.whereName(name);
+                    for (size_t i = 0; i < lastSearch.size(); ++i) companies.at(lastSearch[i]).display();
                 } else if (filter == 2) {
                     double percent;
                     std::cout << "Minimum % unused: "; std::cin >> percent;
-                    lastSearch.clear();
-                    for (std::unordered_map<int, KC>::const_iterator it = companies.begin(); it != companies.end(); ++it) {
-                        if (it->second.getWorkshop() == 0) continue;
-                        double unused = 100.0 * (it->second.getWorkshop() - it->second.getWorkshopInOperation()) / it->second.getWorkshop();
-                        if (unused >= percent) {
-                            it->second.display();
-                            lastSearch.push_back(it->first);
-                        }
-                    }
+                    lastSearch = index.whereUnusedAtLeast(percent);
+                    for (size_t i = 0; i < lastSearch.size(); ++i) companies.at(lastSearch[i]).display();
+                } else if (filter >= 3 && filter <= 5) {
+                    std::string text;
+                    std::cout << "Enter text (case ignored): ";
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    getline(std::cin, text);
+                    if (filter == 3)      lastSearch = index.whereNamePrefix(text);
+                    else if (filter == 4) lastSearch = index.whereNameContains(text);
+                    else                  lastSearch = index.whereClassesContains(text);
+                    for (size_t i = 0; i < lastSearch.size(); ++i) companies.at(lastSearch[i]).display();
+                    if (lastSearch.empty()) std::cout << "No objects found.\n";
                 } else {
                     std::cout << "Invalid filter.\n";
                     break;
@@ -104,7 +111,7 @@ void manageCompanies(std::unordered_map<int, KC>& companies) {
                             case 2: {
                                 int id;
                                 std::cout << "Enter ID to edit: "; std::cin >> id;
-                                if (companies.count(id)) { companies[id].editWorkshops();
+                                if (companies.count(id)) { companies[id].editWorkshops(); index.upsert(companies[id]);
                                     Logger::logAction("EDIT COMPANY", id, companies[id].getName(), companies[id].getWorkshop(), companies[id].getWorkshopInOperation(), companies[id].getClasses()); }
                                 else std::cout << "Not found.\n";
                                 break;
@@ -112,7 +119,8 @@ void manageCompanies(std::unordered_map<int, KC>& companies) {
                             case 3: {
                                 int id;
                                 std::cout << "Enter ID to delete: "; std::cin >> id;
-                                if (companies.count(id)) { Logger::logAction("DELETE COMPANY", id, companies[id].getName(), companies[id].getWorkshop(), companies[id].getWorkshopInOperation(), companies[id].getClasses()); companies.erase(id); std::cout << "Deleted.\n"; }
+                                if (companies.count(id) && !network.canDeleteKC(id)) std::cout << "This company is used in the network and cannot be deleted.\n";
+                                else if (companies.count(id)) { Logger::logAction("DELETE COMPANY", id, companies[id].getName(), companies[id].getWorkshop(), companies[id].getWorkshopInOperation(), companies[id].getClasses()); companies.erase(id); index.erase(id); std::cout << "Deleted.\n"; }
                                 else std::cout << "Not found.\n";
                                 break;
                             }
@@ -148,21 +156,23 @@ void manageCompanies(std::unordered_map<int, KC>& companies) {
 KC::KC(int id_, const std::string& name_, int workshop_, int workshop_in_operation_, const std::string& classes_)
     : id(id_), name(name_), workshop(workshop_), workshop_in_operation(workshop_in_operation_), classes(classes_) {}
 
-KC::KC() : id(0), name(""), workshop(0), workshop_in_operation(0), classes("") {}
+KC::KC() : id(0), name(), workshop(0), workshop_in_operation(0), classes() {}
 
 int KC::getId() const { return id; }
-const std::string& KC::getName() const { return name; }
+const std::string& KC::getName() const { return name.str(); }
 int KC::getWorkshop() const { return workshop; }
 int KC::getWorkshopInOperation() const { return workshop_in_operation; }
-const std::string& KC::getClasses() const { return classes; }
+const std::string& KC::getClasses() const { return classes.str(); }
 void KC::setId(int newId) { id = newId; }
 
 void KC::input(int newId) {
     id = newId;
     std::cout << "Enter the informations of the company in this order:\nname, number of workshops, number of workshops in operation, classes\n";
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::string text;
     std::cout << "Name: ";
-    getline(std::cin, name);
+    getline(std::cin, text);
+    name = text;
     while (true) {
         std::cout << "Number of workshops: ";
         if (std::cin >> workshop && workshop > 0) break;
@@ -179,7 +189,8 @@ void KC::input(int newId) {
     }
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     std::cout << "Classes: ";
-    getline(std::cin, classes);
+    getline(std::cin, text);
+    classes = text;
 }
 
 void KC::display() const {
@@ -217,13 +228,16 @@ std::ostream& operator<<(std::ostream& os, const KC& c) {
 }
 
 std::istream& operator>>(std::istream& is, KC& c) {
+    std::string text;
     is >> c.id;
     is.ignore();
-    getline(is, c.name, '\t');
+    getline(is, text, '\t');
+    c.name = text;
     is >> c.workshop;
     is.ignore();
     is >> c.workshop_in_operation;
     is.ignore();
-    getline(is, c.classes);
+    getline(is, text);
+    c.classes = text;
     return is;
 }
\ No newline at end of file
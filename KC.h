@@ -3,19 +3,25 @@
 #include <string>
 #include <iostream>
 #include <unordered_map>
+#include "StringPool.h"
+
+class CompanyIndex;
+class GasNetwork;
+class IdAllocator;
 
 class KC {
 private:
     int id;
-    std::string name;
-    int workshop;
+    PooledString name;       // handles vers le pool : les libellés de classes
+    int workshop;            // répétés ne sont stockés qu'une fois
     int workshop_in_operation;
-    std::string classes;
+    PooledString classes;
 public:
     KC(int id_, const std::string& name_, int workshop_, int workshop_in_operation_, const std::string& classes_);
     KC();
     int getId() const;
     const std::string& getName() const;
+    StringPool::Handle getNameHandle() const { return name.handle(); }
     int getWorkshop() const;
     int getWorkshopInOperation() const;
     const std::string& getClasses() const;
@@ -29,5 +35,11 @@ public:
 
 // Fonctions de gestion des KC
 // Adds a company to the map and returns the assigned ID
-int addCompany(std::unordered_map<int, KC>& companies);
-void manageCompanies(std::unordered_map<int, KC>& companies);
\ No newline at end of file
+// (smallest free ID, taken from the allocator)
+int addCompany(std::unordered_map<int, KC>& companies, IdAllocator& ids);
+// Same without prompting (log replay, batch mode)
+int addCompany(std::unordered_map<int, KC>& companies, IdAllocator& ids, const std::string& name,
+               int workshops, int workshopsInOperation, const std::string& classes);
+// a KC still used in the network cannot be deleted (its ID would be reused)
+void manageCompanies(std::unordered_map<int, KC>& companies, CompanyIndex& index,
+                     const GasNetwork& network);
\ No newline at end of file
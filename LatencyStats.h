@@ -0,0 +1,55 @@
+// LatencyStats.h
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+// ---------------------------------------------------------------------
+//  Échantillons de latence (en nanosecondes) et percentiles.
+//  Utilisé par le rejeu du journal et par les benchmarks.
+// ---------------------------------------------------------------------
+class LatencyStats {
+private:
+    std::vector<long long> samples;
+    bool sorted = true;
+
+    void sort() {
+        if (!sorted) { std::sort(samples.begin(), samples.end()); sorted = true; }
+    }
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void add(long long nanos) { samples.push_back(nanos); sorted = false; }
+    void add(Clock::time_point start, Clock::time_point end) {
+        add(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    void clear() { samples.clear(); sorted = true; }
+
+    std::size_t count() const { return samples.size(); }
+    long long total() const {
+        long long sum = 0;
+        for (long long s : samples) sum += s;
+        return sum;
+    }
+
+    // percentile « nearest rank », p dans [0, 100]
+    long long percentile(double p) {
+        if (samples.empty()) return 0;
+        sort();
+        std::size_t rank = static_cast<std::size_t>(p / 100.0 * samples.size() + 0.999999);
+        if (rank == 0) rank = 1;
+        if (rank > samples.size()) rank = samples.size();
+        return samples[rank - 1];
+    }
+    long long min() { return percentile(0); }
+    long long median() { return percentile(50); }
+    long long max() { return percentile(100); }
+
+    // opérations par seconde sur le temps cumulé des échantillons
+    double throughput() const {
+        long long t = total();
+        return t > 0 ? samples.size() * 1e9 / static_cast<double>(t) : 0.0;
+    }
+};
@@ -0,0 +1,156 @@
+// LogDecoder.cpp – convertit un journal binaire (Logger::useBinaryLog)
+// vers le format texte de user_actions.log ou vers du CSV.
+//
+//   g++ -std=c++11 -O2 -o logdecode LogDecoder.cpp EventLog.cpp
+//   logdecode user_actions.bin              > user_actions.log
+//   logdecode user_actions.bin --csv -o actions.csv
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <ctime>
+#include <iomanip>
+#include "EventLog.h"
+
+namespace {
+
+std::tm localTime(std::int64_t millis) {
+    std::time_t t = static_cast<std::time_t>(millis / 1000);
+    return *std::localtime(&t);
+}
+
+std::string csvField(const std::string& s) {
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+const char* typeName(EventType type) {
+    switch (type) {
+        case EventType::Text:          return "text";
+        case EventType::PipeSimple:    return "pipe";
+        case EventType::PipeAction:    return "pipe_action";
+        case EventType::CompanySimple: return "company";
+        case EventType::CompanyAction: return "company_action";
+        default:                       return "unknown";
+    }
+}
+
+/* ---------------------------------------------------------------------
+   Reproduit exactement ce qu'écrit Logger en mode texte : les compteurs
+   « actionN » repartent à 1 à chaque session, comme dans le programme.
+   --------------------------------------------------------------------- */
+void writeText(BinaryEventReader& in, std::ostream& out) {
+    int pipeCounter = 1, companyCounter = 1;
+    EventRecord rec;
+    while (in.next(rec)) {
+        EventType type = static_cast<EventType>(rec.type);
+        switch (type) {
+            case EventType::SessionStart:
+                pipeCounter = companyCounter = 1;
+                break;
+            case EventType::Text: {
+                std::tm tm = localTime(rec.timestamp);
+                out << "[" << std::put_time(&tm, "%Y-%m-%d %H:%M:%S") << "] "
+                    << in.str(rec.label) << '\n';
+                break;
+            }
+            case EventType::PipeSimple:
+            case EventType::PipeAction:
+                out << "action" << pipeCounter++
+                    << (type == EventType::PipeSimple ? " for the pipes" : " for the pipe") << '\n'
+                    << in.str(rec.name) << '\n'
+                    << rec.length << '\n'
+                    << static_cast<double>(rec.a) << '\n'
+                    << ((rec.flags & EVENT_FLAG_REPAIR) ? "yes" : "no") << '\n';
+                if (type == EventType::PipeAction) out << in.str(rec.label) << '\n';
+                break;
+            case EventType::CompanySimple:
+            case EventType::CompanyAction:
+                out << "action" << companyCounter++ << " for the companies" << '\n'
+                    << in.str(rec.name) << '\n'
+                    << rec.a << '\n'
+                    << rec.b << '\n'
+                    << in.str(rec.classes) << '\n';
+                if (type == EventType::CompanyAction) out << in.str(rec.label) << '\n';
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void writeCsv(BinaryEventReader& in, std::ostream& out) {
+    out << "session,timestamp,event,id,name,length,diameter,repair,"
+           "workshops,workshops_in_operation,classes,label\n";
+    int session = 0;
+    EventRecord rec;
+    while (in.next(rec)) {
+        EventType type = static_cast<EventType>(rec.type);
+        if (type == EventType::SessionStart) { ++session; continue; }
+
+        std::tm tm = localTime(rec.timestamp);
+        out << session << ','
+            << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S") << '.'
+            << std::setw(3) << std::setfill('0') << (rec.timestamp % 1000) << std::setfill(' ')
+            << ',' << typeName(type) << ',';
+
+        bool isPipe    = type == EventType::PipeSimple || type == EventType::PipeAction;
+        bool isCompany = type == EventType::CompanySimple || type == EventType::CompanyAction;
+        if (isPipe || isCompany) out << rec.id;
+        out << ',' << csvField(in.str(rec.name)) << ',';
+        if (isPipe) out << rec.length << ',' << rec.a << ','
+                        << ((rec.flags & EVENT_FLAG_REPAIR) ? 1 : 0) << ",,";
+        else if (isCompany) out << ",,," << rec.a << ',' << rec.b;
+        else out << ",,,,";
+        out << ',' << csvField(in.str(rec.classes))
+            << ',' << csvField(in.str(rec.label)) << '\n';
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string input, output;
+    bool csv = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--csv") csv = true;
+        else if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else if (input.empty()) input = arg;
+        else {
+            std::cerr << "Unexpected argument: " << arg << '\n';
+            return 2;
+        }
+    }
+    if (input.empty()) {
+        std::cerr << "Usage: logdecode <log.bin> [--csv] [-o output]\n";
+        return 2;
+    }
+
+    BinaryEventReader reader(input);
+    if (!reader.isValid()) {
+        std::cerr << "Not a binary event log: " << input << '\n';
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file.is_open()) {
+            std::cerr << "Unable to open " << output << '\n';
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+    if (csv) writeCsv(reader, out);
+    else     writeText(reader, out);
+    if (reader.isCorrupt()) {
+        std::cerr << "Corrupt binary event log: " << input << " (decoded up to the damage)\n";
+        return 1;
+    }
+    return out ? 0 : 1;
+}
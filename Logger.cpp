@@ -3,3 +3,5 @@
 // Initialize static counters - MUST be defined exactly once in the .cpp file
 int Logger::pipeActionCounter = 1;
 int Logger::companyActionCounter = 1;
+std::unique_ptr<BinaryEventLog> Logger::binaryLog;
+bool Logger::muted = false;
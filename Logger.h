@@ -4,17 +4,37 @@
 #include <string>
 #include <chrono>
 #include <iomanip>
+#include <memory>
+#include "EventLog.h"
 
 class Logger {
 private:
     static int pipeActionCounter;
     static int companyActionCounter;
+    static std::unique_ptr<BinaryEventLog> binaryLog;   // nullptr = journal texte
+    static bool muted;                                   // outils headless (rejeu, benchmarks)
 
 public:
+    // -----------------------------------------------------------------
+    //  Mode binaire (optionnel) : enregistrements de taille fixe, sans
+    //  formatage. Relire avec l'outil logdecode (LogDecoder.cpp).
+    // -----------------------------------------------------------------
+    static bool useBinaryLog(const std::string& path) {
+        std::unique_ptr<BinaryEventLog> log(new BinaryEventLog(path));
+        if (!log->isOpen()) return false;
+        binaryLog = std::move(log);
+        return true;
+    }
+    static void useTextLog() { binaryLog.reset(); }
+    static void flush() { if (binaryLog) binaryLog->flush(); }
+    static void setMuted(bool m) { muted = m; }
+
     // -----------------------------------------------------------------
     //  Log simple (texte libre)
     // -----------------------------------------------------------------
     static void logAction(const std::string& action) {
+        if (muted) return;
+        if (binaryLog) { binaryLog->text(action); return; }
         std::ofstream logfile("user_actions.log", std::ios::app);
         if (logfile.is_open()) {
             auto now = std::chrono::system_clock::now();
@@ -29,6 +49,12 @@ public:
     // -----------------------------------------------------------------
     static void logPipeSimple(const std::string& name, double length,
                               double diameter, bool underRepair) {
+        if (muted) return;
+        if (binaryLog) {
+            binaryLog->pipe(EventType::PipeSimple, std::string(), 0, name, length,
+                            static_cast<int>(diameter), underRepair);
+            return;
+        }
         std::ofstream logfile("user_actions.log", std::ios::app);
         if (logfile.is_open()) {
             logfile << "action" << pipeActionCounter << " for the pipes" << std::endl;
@@ -46,6 +72,12 @@ public:
     static void logAction(const std::string& actionLabel, int id,
                           const std::string& name, double length,
                           double diameter, bool underRepair) {
+        if (muted) return;
+        if (binaryLog) {   // le format binaire conserve l’ID
+            binaryLog->pipe(EventType::PipeAction, actionLabel, id, name, length,
+                            static_cast<int>(diameter), underRepair);
+            return;
+        }
         (void)id;   // le format de log ne prévoit pas l’ID → on le « silence »
         std::ofstream logfile("user_actions.log", std::ios::app);
         if (logfile.is_open()) {
@@ -65,6 +97,12 @@ public:
     static void logCompanySimple(const std::string& name, int workshops,
                                  int workshopsInOperation,
                                  const std::string& classes) {
+        if (muted) return;
+        if (binaryLog) {
+            binaryLog->company(EventType::CompanySimple, std::string(), 0, name,
+                               workshops, workshopsInOperation, classes);
+            return;
+        }
         std::ofstream logfile("user_actions.log", std::ios::app);
         if (logfile.is_open()) {
             logfile << "action" << companyActionCounter << " for the companies" << std::endl;
@@ -82,6 +120,12 @@ public:
     static void logAction(const std::string& actionLabel, int id,
                           const std::string& name, int workshops,
                           int workshopsInOperation, const std::string& classes) {
+        if (muted) return;
+        if (binaryLog) {
+            binaryLog->company(EventType::CompanyAction, actionLabel, id, name,
+                               workshops, workshopsInOperation, classes);
+            return;
+        }
         (void)id;   // idem, l’ID n’est pas utilisé dans le format texte
         std::ofstream logfile("user_actions.log", std::ios::app);
         if (logfile.is_open()) {
@@ -0,0 +1,220 @@
+#include "NetworkGenerator.h"
+#include "DiskGraph.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+namespace {
+// flux indépendants : changer un paramètre de pipes ne décale pas les KC
+const std::uint64_t STREAM_TOPOLOGY = 0x746F706FULL;
+const std::uint64_t STREAM_PIPE     = 0x70697065ULL;
+const std::uint64_t STREAM_COMPANY  = 0x6B637321ULL;
+
+const char* const CLASS_LABELS[] = { "A", "B", "C", "D", "E" };
+
+SplitMix64 elementRng(std::uint64_t seed, std::uint64_t stream, int id) {
+    SplitMix64 mix(seed ^ (stream * 0xD6E8FEB86659FD93ULL));
+    return SplitMix64(mix.next() ^ (static_cast<std::uint64_t>(id) * 0x9E3779B97F4A7C15ULL));
+}
+}
+
+double SplitMix64::normal() {
+    // Box-Muller (une seule valeur, l'autre est jetée)
+    double u1 = uniform(), u2 = uniform();
+    if (u1 < 1e-300) u1 = 1e-300;
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+/*======================================================================
+   TOPOLOGIE (générée une fois, elle fixe le nombre de pipes)
+======================================================================*/
+NetworkGenerator::NetworkGenerator(const GeneratorParams& p)
+    : params(p), pipeTotal(0), dropped(0), levels(0), diameterWeightSum(0.0) {
+    if (params.companies < 0) params.companies = 0;
+    if (params.regions < 1) params.regions = 1;
+    if (params.regions > std::max(1, params.companies)) params.regions = std::max(1, params.companies);
+    for (const auto& d : params.diameterMix) diameterWeightSum += d.second;
+
+    SplitMix64 rng(params.seed ^ STREAM_TOPOLOGY);
+    std::vector<int> picked;
+
+    for (int r = 0, base = 0; r < params.regions; ++r) {
+        int size = params.companies / params.regions +
+                   (r < params.companies % params.regions ? 1 : 0);
+        regionStart.push_back(base + 1);
+
+        int width = params.width > 0 ? params.width
+                                     : std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(size)))));
+        if (params.depth > 0) width = std::max(1, (size + params.depth - 1) / params.depth);
+        levels = std::max(levels, (size + width - 1) / width);
+
+        // niveau l = IDs [base + l*width + 1, base + (l+1)*width]
+        for (int i = width; i < size; ++i) {
+            int level = i / width;
+            int to    = base + i + 1;
+            if (params.topology == GeneratorParams::Topology::Tree) {
+                int lo = (level - 1) * width;
+                edges.push_back({ base + rng.range(lo, lo + width - 1) + 1, to, 0 });
+                continue;
+            }
+            int lo = std::max(0, level - params.span) * width;
+            int hi = level * width - 1;
+            int want = std::min(params.fanIn, hi - lo + 1);
+            picked.clear();
+            for (int attempt = 0; static_cast<int>(picked.size()) < want && attempt < 4 * want; ++attempt) {
+                int from = base + rng.range(lo, hi) + 1;
+                if (std::find(picked.begin(), picked.end(), from) == picked.end())
+                    picked.push_back(from);
+            }
+            for (int from : picked) edges.push_back({ from, to, 0 });
+        }
+        base += size;
+    }
+    regionStart.push_back(params.companies + 1);
+
+    // interconnexions région r → r+1
+    for (int r = 0; r + 1 < params.regions; ++r) {
+        std::size_t first = edges.size();
+        for (int k = 0; k < params.interconnects; ++k) {
+            int from = rng.range(regionStart[r],     regionStart[r + 1] - 1);
+            int to   = rng.range(regionStart[r + 1], regionStart[r + 2] - 1);
+            bool dup = false;
+            for (std::size_t e = first; e < edges.size() && !dup; ++e)
+                dup = edges[e].from == from && edges[e].to == to;
+            if (!dup) edges.push_back({ from, to, 0 });
+        }
+    }
+
+    // un pipe distinct par connexion ; au-delà, les pipes restent libres
+    if (params.pipes > 0) {
+        pipeTotal = params.pipes;
+        if (edges.size() > static_cast<std::size_t>(pipeTotal)) {
+            dropped = edges.size() - pipeTotal;               // signalé par droppedConnections()
+            edges.resize(pipeTotal);
+        }
+    } else {
+        pipeTotal = static_cast<int>(std::ceil(edges.size() * (1.0 + params.sparePipes)));
+    }
+    for (std::size_t e = 0; e < edges.size(); ++e) edges[e].pipe_id = static_cast<int>(e) + 1;
+}
+
+int NetworkGenerator::regionOf(int id) const {
+    if (id < 1 || id > params.companies) return -1;
+    return static_cast<int>(std::upper_bound(regionStart.begin(), regionStart.end(), id) - regionStart.begin()) - 1;
+}
+
+std::unordered_map<int, int> NetworkGenerator::regionMap() const {
+    std::unordered_map<int, int> map;
+    map.reserve(params.companies);
+    for (int r = 0; r + 1 < static_cast<int>(regionStart.size()); ++r)
+        for (int id = regionStart[r]; id < regionStart[r + 1]; ++id) map[id] = r;
+    return map;
+}
+
+/*======================================================================
+   OBJETS
+======================================================================*/
+Pipe NetworkGenerator::pipe(int id) const {
+    return pipeWithName(id, "pipe" + std::to_string(id));
+}
+
+KC NetworkGenerator::company(int id) const {
+    return companyWithName(id, "KC" + std::to_string(id));
+}
+
+Pipe NetworkGenerator::pipeWithName(int id, const std::string& name) const {
+    SplitMix64 rng = elementRng(params.seed, STREAM_PIPE, id);
+
+    int diameter = params.diameterMix.empty() ? 1000 : params.diameterMix.back().first;
+    double pick = rng.uniform() * diameterWeightSum;
+    for (const auto& d : params.diameterMix) {
+        if (pick < d.second) { diameter = d.first; break; }
+        pick -= d.second;
+    }
+
+    double length;
+    switch (params.lengthDistribution) {
+        case GeneratorParams::LengthDistribution::LogNormal:
+            length = std::exp(params.lengthA + params.lengthB * rng.normal());
+            break;
+        case GeneratorParams::LengthDistribution::Fixed:
+            length = params.lengthA;
+            break;
+        default:
+            length = params.lengthA + (params.lengthB - params.lengthA) * rng.uniform();
+    }
+    length = std::max(0.1, std::round(length * 10.0) / 10.0);       // 0.1 m près
+
+    bool repair = rng.uniform() < params.repairRatio;
+    return Pipe(id, name, static_cast<float>(length), diameter, repair);
+}
+
+KC NetworkGenerator::companyWithName(int id, const std::string& name) const {
+    SplitMix64 rng = elementRng(params.seed, STREAM_COMPANY, id);
+    int workshops   = rng.range(1, 20);
+    int inOperation = rng.range(0, workshops);
+    const int nLabels = sizeof(CLASS_LABELS) / sizeof(CLASS_LABELS[0]);
+    return KC(id, name, workshops, inOperation,
+              CLASS_LABELS[rng.range(0, nLabels - 1)]);
+}
+
+void NetworkGenerator::build(std::unordered_map<int, Pipe>& pipes,
+                             std::unordered_map<int, KC>& companies) const {
+    pipes.clear();
+    companies.clear();
+    pipes.reserve(pipeTotal);
+    companies.reserve(params.companies);
+    for (int id = 1; id <= pipeTotal; ++id) pipes.emplace(id, pipe(id));
+    for (int id = 1; id <= params.companies; ++id) companies.emplace(id, company(id));
+}
+
+bool NetworkGenerator::writeDataFile(const std::string& filename) const {
+    std::vector<char> buf(1 << 20);
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(buf.data(), buf.size());   // avant open() pour être pris en compte
+    file.open(filename);
+    if (!file.is_open()) return false;
+
+    // mêmes lignes que operator<< de Pipe / KC, mais le nom est écrit
+    // directement : un million de noms internés ne seraient jamais rendus
+    file << pipeTotal << '\n';
+    for (int id = 1; id <= pipeTotal; ++id) {
+        Pipe p = pipeWithName(id, std::string());
+        file << id << "\tpipe" << id << '\t' << p.getLength() << '\t'
+             << p.getDiameter() << '\t' << p.isRepair() << '\n';
+    }
+    file << params.companies << '\n';
+    for (int id = 1; id <= params.companies; ++id) {
+        KC c = companyWithName(id, std::string());
+        file << id << "\tKC" << id << '\t' << c.getWorkshop() << '\t'
+             << c.getWorkshopInOperation() << '\t' << c.getClasses() << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+// Sans passer par les maps : les connexions sont triées par origine
+// (tri par dénombrement, indices seulement), chaque tuyau est recalculé
+// depuis la graine au moment de l'écrire. Restent en mémoire : edges
+// (12 octets par arête), order (4) et first / at (2 × 4 par KC).
+bool NetworkGenerator::writeDiskGraph(const std::string& filename) const {
+    const int n = params.companies;
+    std::vector<int> first(n + 2, 0), order(edges.size());
+    for (const ConnectionRecord& c : edges) ++first[c.from + 1];
+    for (int id = 1; id <= n + 1; ++id) first[id] += first[id - 1];
+    std::vector<int> at(first.begin(), first.end() - 1);
+    for (std::size_t e = 0; e < edges.size(); ++e) order[at[edges[e].from]++] = static_cast<int>(e);
+
+    DiskGraph::Writer w;
+    if (!w.open(filename, n, edges.size(), pipeTotal)) return false;
+    for (int id = 1; id <= n; ++id) {
+        w.addNode(id);
+        for (int k = first[id]; k < first[id + 1]; ++k) {
+            const ConnectionRecord& c = edges[order[k]];
+            Pipe p = pipeWithName(c.pipe_id, std::string());
+            w.addEdge(c.to - 1, c.pipe_id, p.getCapacity(), p.getWeight());   // indice dense = ID - 1
+        }
+    }
+    for (int id = 1; id <= pipeTotal; ++id) w.addPipe(DiskGraph::record(pipeWithName(id, std::string())));
+    return w.finish();
+}
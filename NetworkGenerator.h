@@ -0,0 +1,102 @@
+// NetworkGenerator.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Pipe.h"
+#include "KC.h"
+#include "DataFile.h"
+
+// ---------------------------------------------------------------------
+//  Générateur déterministe de réseaux synthétiques (tests de montée en
+//  charge). Même graine + mêmes paramètres = mêmes fichiers, quel que
+//  soit le compilateur : on n'utilise pas les distributions de <random>
+//  (non spécifiées par la norme) mais un SplitMix64 maison.
+//
+//  Chaque région est un DAG en niveaux (KC d'un niveau → niveaux
+//  suivants) ; les régions sont reliées par quelques interconnexions
+//  toujours orientées de la région r vers r+1, donc le tout reste acyclique.
+// ---------------------------------------------------------------------
+
+class SplitMix64 {
+private:
+    std::uint64_t state;
+public:
+    explicit SplitMix64(std::uint64_t seed) : state(seed) {}
+    std::uint64_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }   // [0, 1)
+    int range(int lo, int hi) {                                                 // [lo, hi]
+        return lo + static_cast<int>(next() % static_cast<std::uint64_t>(hi - lo + 1));
+    }
+    double normal();
+};
+
+struct GeneratorParams {
+    enum class Topology { Tree, Mesh };
+    enum class LengthDistribution { Uniform, LogNormal, Fixed };
+
+    std::uint64_t seed        = 1;
+    int      companies        = 1000;
+    int      pipes            = 0;       // 0 = une par connexion + sparePipes ; moins que
+                                         // de connexions : l'excédent est abandonné
+    double   sparePipes       = 0.10;    // part de pipes libres en plus
+    int      width            = 0;       // KC par niveau (0 = racine carrée de la région)
+    int      depth            = 0;       // nombre de niveaux (prioritaire sur width)
+    Topology topology         = Topology::Tree;
+    int      fanIn            = 3;       // Mesh : parents par KC
+    int      span             = 2;       // Mesh : niveaux précédents candidats
+    int      regions          = 1;
+    int      interconnects    = 2;       // arêtes entre deux régions successives
+    std::vector<std::pair<int, double>> diameterMix =
+        { {500, 1.0}, {700, 1.0}, {1000, 1.0}, {1400, 1.0} };
+    LengthDistribution lengthDistribution = LengthDistribution::Uniform;
+    double   lengthA          = 10.0;    // Uniform : min, LogNormal : mu,    Fixed : valeur
+    double   lengthB          = 1000.0;  // Uniform : max, LogNormal : sigma
+    double   repairRatio      = 0.05;
+};
+
+class NetworkGenerator {
+private:
+    GeneratorParams              params;
+    std::vector<ConnectionRecord> edges;
+    int                          pipeTotal;
+    std::size_t                  dropped;         // connexions sans pipe (params.pipes trop petit)
+    int                          levels;          // profondeur max d'une région
+    std::vector<int>             regionStart;     // premier ID de chaque région (+ fin)
+    double                       diameterWeightSum;
+
+    // Attributs seuls, nom fourni par l'appelant : avec "" rien n'est
+    // interné (le StringPool ne libère jamais rien, cf. writeDataFile)
+    Pipe pipeWithName(int id, const std::string& name) const;
+    KC   companyWithName(int id, const std::string& name) const;
+
+public:
+    explicit NetworkGenerator(const GeneratorParams& p);
+
+    const std::vector<ConnectionRecord>& connections() const { return edges; }
+    int pipeCount() const { return pipeTotal; }
+    std::size_t droppedConnections() const { return dropped; }
+    int companyCount() const { return params.companies; }
+    int depth() const { return levels; }
+    const GeneratorParams& parameters() const { return params; }
+
+    // région d'une KC (IDs contigus par région) ; -1 hors du réseau
+    int regionOf(int id) const;
+    std::unordered_map<int, int> regionMap() const;          // pour GasNetwork::setRegions
+
+    // Chaque objet ne dépend que de (graine, ID) : génération en flux possible
+    Pipe pipe(int id) const;
+    KC   company(int id) const;
+
+    void build(std::unordered_map<int, Pipe>& pipes,
+               std::unordered_map<int, KC>& companies) const;
+    bool writeDataFile(const std::string& filename) const;   // format de saveToFile
+    bool writeDiskGraph(const std::string& filename) const;  // format DiskGraph, KC 1..companies
+};
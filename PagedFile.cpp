@@ -0,0 +1,112 @@
+#include "PagedFile.h"
+#include <algorithm>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PAGED_FILE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const std::size_t PagedFile::CHUNK;
+
+/*======================================================================
+   OUVERTURE / FERMETURE
+======================================================================*/
+bool PagedFile::open(const std::string& filename, std::size_t maxChunks) {
+    close();
+    capacity = std::max<std::size_t>(1, maxChunks);
+#ifdef PAGED_FILE_MMAP
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(); return false; }
+    fileSize = static_cast<std::uint64_t>(st.st_size);
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);   // lecture anticipée plus large
+#endif
+#else
+    std::FILE* f = std::fopen(filename.c_str(), "rb");
+    if (!f) return false;
+    file = f;
+    std::fseek(f, 0, SEEK_END);
+    fileSize = static_cast<std::uint64_t>(std::ftell(f));
+#endif
+    slots.reserve(capacity);
+    return true;
+}
+
+void PagedFile::close() {
+    for (Slot& s : slots) release(s);
+    slots.clear();
+#ifdef PAGED_FILE_MMAP
+    if (fd >= 0) ::close(fd);
+#else
+    if (file) std::fclose(static_cast<std::FILE*>(file));
+#endif
+    fd = -1;
+    file = nullptr;
+    fileSize = 0;
+    lastBegin = 1;
+    lastEnd = 0;
+    lastData = nullptr;
+}
+
+void PagedFile::release(Slot& s) {
+#ifdef PAGED_FILE_MMAP
+    if (s.data && s.buffer.empty()) munmap(const_cast<char*>(s.data), s.length);
+#endif
+    s.data = nullptr;
+    s.buffer.clear();
+}
+
+/*======================================================================
+   BLOCS – cache LRU
+======================================================================*/
+// offset < fileSize (vérifié par read)
+const char* PagedFile::load(std::uint64_t offset) {
+    const std::uint64_t chunk = offset / CHUNK;
+    Slot* slot = nullptr;
+    for (Slot& s : slots)                              // quelques blocs : parcours linéaire
+        if (s.chunk == chunk && s.data) { slot = &s; break; }
+
+    if (slot) {
+        ++hits;
+    } else {
+        ++loads;
+        if (slots.size() < capacity) {
+            slots.push_back(Slot());
+            slot = &slots.back();
+        } else {
+            slot = &*std::min_element(slots.begin(), slots.end(),
+                [](const Slot& a, const Slot& b) { return a.lastUse < b.lastUse; });
+            release(*slot);
+        }
+        const std::uint64_t begin = chunk * CHUNK;
+        slot->chunk  = chunk;
+        slot->length = static_cast<std::size_t>(std::min<std::uint64_t>(CHUNK, fileSize - begin));
+#ifdef PAGED_FILE_MMAP
+        void* p = mmap(nullptr, slot->length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(begin));
+        if (p == MAP_FAILED) {                         // bloc illisible : zéros
+            slot->buffer.assign(slot->length, 0);
+            slot->data = slot->buffer.data();
+        } else {
+            slot->data = static_cast<const char*>(p);
+        }
+#else
+        slot->buffer.assign(slot->length, 0);
+        std::FILE* f = static_cast<std::FILE*>(file);
+        std::fseek(f, static_cast<long>(begin), SEEK_SET);
+        std::size_t got = std::fread(slot->buffer.data(), 1, slot->length, f);
+        (void)got;                                     // fin de fichier : reste à zéro
+        slot->data = slot->buffer.data();
+#endif
+    }
+    slot->lastUse = ++clock;
+    lastBegin = slot->chunk * CHUNK;
+    lastEnd   = lastBegin + slot->length;
+    lastData  = slot->data;
+    return lastData + (offset - lastBegin);
+}
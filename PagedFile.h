@@ -0,0 +1,82 @@
+// PagedFile.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------
+//  Lecture d'un gros fichier par blocs alignés sur les pages, avec un
+//  petit cache LRU des blocs chauds : la mémoire occupée reste bornée
+//  (maxChunks × CHUNK) quelle que soit la taille du fichier.
+//
+//  Un bloc est projeté en mémoire (mmap, lecture seule) à la première
+//  lecture qui le touche ; quand le cache est plein, le bloc utilisé le
+//  moins récemment est libéré (munmap). Sans mmap (Windows), le bloc est
+//  lu dans un tampon. Un parcours séquentiel ne touche chaque bloc
+//  qu'une fois ; le dernier bloc lu est testé en premier, sans passer
+//  par le cache.
+//
+//  read<T>() rend une copie : aucun pointeur vers un bloc ne survit à
+//  une éviction. Une valeur ne doit pas chevaucher deux blocs (sections
+//  alignées sur les pages, éléments de 4 ou 8 octets). Un seul thread
+//  par PagedFile : chaque lecteur ouvre le fichier de son côté.
+// ---------------------------------------------------------------------
+class PagedFile {
+public:
+    static const std::size_t CHUNK = std::size_t(1) << 20;      // 1 Mo, multiple des pages
+
+private:
+    struct Slot {
+        std::uint64_t     chunk = 0;
+        const char*       data = nullptr;
+        std::size_t       length = 0;
+        std::uint64_t     lastUse = 0;
+        std::vector<char> buffer;                  // sans mmap
+    };
+
+    int                fd = -1;
+    void*              file = nullptr;             // std::FILE* sans mmap
+    std::uint64_t      fileSize = 0;
+    std::vector<Slot>  slots;                      // capacity au plus
+    std::size_t        capacity = 16;
+    std::uint64_t      clock = 0;
+    std::uint64_t      hits = 0, loads = 0;
+
+    // dernier bloc lu (raccourci des parcours séquentiels)
+    std::uint64_t      lastBegin = 1, lastEnd = 0;
+    const char*        lastData = nullptr;
+
+    const char* load(std::uint64_t offset);        // adresse de offset, bloc chargé au besoin
+    void        release(Slot& s);
+
+    PagedFile(const PagedFile&);
+    PagedFile& operator=(const PagedFile&);
+
+public:
+    PagedFile() {}
+    ~PagedFile() { close(); }
+
+    bool open(const std::string& filename, std::size_t maxChunks = 16);
+    void close();
+    bool isOpen() const { return fd >= 0 || file != nullptr; }
+
+    std::uint64_t size() const { return fileSize; }
+
+    // hors du fichier : T() (jamais de lecture hors des blocs)
+    template<typename T>
+    T read(std::uint64_t offset) {
+        T value = T();
+        if (offset >= lastBegin && offset + sizeof(T) <= lastEnd)
+            std::memcpy(&value, lastData + (offset - lastBegin), sizeof(T));
+        else if (offset < fileSize && fileSize - offset >= sizeof(T))
+            std::memcpy(&value, load(offset), sizeof(T));
+        return value;
+    }
+
+    // statistiques : changements de bloc servis par le cache / blocs chargés
+    std::uint64_t hitCount() const  { return hits; }
+    std::uint64_t loadCount() const { return loads; }
+    std::size_t   residentChunks() const { return slots.size(); }
+};
@@ -2,25 +2,17 @@
 #include "Logger.h"
 #include "Pipe.h"
 #include "GasNetwork.h"
+#include "PipeStore.h"
 #include <functional>
 #include <algorithm>
 #include <limits>
 #include <cmath>
 
-// ---------------------------------------------------------------------
-//  Helper : retourne le plus petit ID libre (évite les doublons)
-// ---------------------------------------------------------------------
-static int getNextId(const std::unordered_map<int, Pipe>& pipes) {
-    int id = 1;
-    while (pipes.count(id)) ++id;
-    return id;
-}
-
 /* --------------------------------------------------------------------
-   addPipe utilise le helper pour générer un ID sans trous
+   addPipe prend le plus petit ID libre dans l'allocateur (sans trous)
    -------------------------------------------------------------------- */
-int addPipe(std::unordered_map<int, Pipe>& pipes) {
-    int newId = getNextId(pipes);
+int addPipe(std::unordered_map<int, Pipe>& pipes, IdAllocator& ids) {
+    int newId = ids.acquire();
     Pipe p;
     p.input(newId);
     pipes[newId] = p;
@@ -30,11 +22,22 @@ int addPipe(std::unordered_map<int, Pipe>& pipes) {
     return newId;
 }
 
+/* --------------------------------------------------------------------
+   Variante non interactive (rejeu du journal, mode batch)
+   -------------------------------------------------------------------- */
+int addPipe(std::unordered_map<int, Pipe>& pipes, IdAllocator& ids, const std::string& name,
+            float length, int diameter, bool repair) {
+    int newId = ids.acquire();
+    pipes[newId] = Pipe(newId, name, length, diameter, repair);
+    Logger::logPipeSimple(name, length, diameter, repair);
+    return newId;
+}
+
 /* --------------------------------------------------------------------
    Le reste du fichier est exactement votre version d’origine.
    -------------------------------------------------------------------- */
 
-void batchEditPipes(std::unordered_map<int, Pipe>& pipes,
+void batchEditPipes(std::unordered_map<int, Pipe>& pipes, PipeStore& store,
                     const std::vector<int>& ids, GasNetwork& network) {
     if (ids.empty()) {
         std::cout << "No pipes to edit.\n";
@@ -49,17 +52,19 @@ void batchEditPipes(std::unordered_map<int, Pipe>& pipes,
         int id;
         while (std::cin >> id && id != -1) toEdit.push_back(id);
     }
+    std::vector<int> edited;
     for (size_t i = 0; i < toEdit.size(); ++i) {
         int id = toEdit[i];
         if (pipes.count(id)) {
             pipes[id].editRepair();
+            store.setRepair(id, pipes[id].isRepair());
             Logger::logAction("EDIT PIPE", id, pipes[id].getName(),
                              pipes[id].getLength(), pipes[id].getDiameter(),
                              pipes[id].isRepair());
-            if (network.isPipeInNetwork(id))
-                network.updatePipeInNetwork(id, pipes[id]);
+            edited.push_back(id);
         }
     }
+    network.updatePipesInNetwork(edited);          // une seule passe, une version
     std::cout << "Batch edit complete.\n";
 }
 
@@ -91,10 +96,33 @@ std::vector<int> searchObjects(const std::unordered_map<int, T>& objects,
     return found;
 }
 
+// Instanciations explicites : les templates sont définis ici mais utilisés
+// aussi ailleurs (benchmarks)
+template void displayAll<Pipe>(const std::unordered_map<int, Pipe>&);
+template void displayAll<KC>(const std::unordered_map<int, KC>&);
+template std::vector<int> searchObjects<Pipe>(const std::unordered_map<int, Pipe>&,
+                                              std::function<bool(const Pipe&)>);
+template std::vector<int> searchObjects<KC>(const std::unordered_map<int, KC>&,
+                                            std::function<bool(const KC&)>);
+
 /* --------------------------------------------------------------------
-   Menu de gestion des pipes (identique à votre version)
+   Affichage des IDs retournés par PipeStore (les filtres n'affichent rien)
    -------------------------------------------------------------------- */
-void managePipes(std::unordered_map<int, Pipe>& pipes, GasNetwork& network) {
+static const std::vector<int>& displayFound(const std::unordered_map<int, Pipe>& pipes,
+                                            const std::vector<int>& ids) {
+    for (int id : ids) {
+        auto it = pipes.find(id);
+        if (it != pipes.end()) it->second.display();
+    }
+    if (ids.empty()) std::cout << "No objects found.\n";
+    return ids;
+}
+
+/* --------------------------------------------------------------------
+   Menu de gestion des pipes
+   -------------------------------------------------------------------- */
+void managePipes(std::unordered_map<int, Pipe>& pipes, PipeStore& store,
+                 GasNetwork& network) {
     int subchoice;
     std::vector<int> lastSearch;
     do {
@@ -117,23 +145,54 @@ void managePipes(std::unordered_map<int, Pipe>& pipes, GasNetwork& network) {
                     std::cout << "Do you want to create a new pipe? (1-yes/0-no): ";
                     int createPipe; std::cin >> createPipe;
                     if (createPipe == 1) {
-                        (void)addPipe(pipes);
+                        int newId = addPipe(pipes, store.allocator());
+                        store.upsert(pipes[newId]);
+                        network.updatePipeInNetwork(newId);
                     }
                     break;
                 }
-                std::cout << "Filter by:\n1. Name\n2. Repair status\nYour choice: ";
+                std::cout << "Filter by:\n1. Name\n2. Repair status\n"
+                             "3. Diameter / length range\n4. Name starts with\n"
+                             "5. Name contains\nYour choice: ";
                 int filter; std::cin >> filter;
                 if (filter == 1) {
                     std::string name;
                     std::cout << "Enter name: ";
                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                     std::getline(std::cin, name);
-                    lastSearch = searchObjects<Pipe>(pipes,
-                        [name](const Pipe& p){ return p.getName() == name; });
+                    lastSearch = displayFound(pipes, store.whereName(name));
                 } else if (filter == 2) {
                     int rep; std::cout << "Repair status (0/1): "; std::cin >> rep;
-                    lastSearch = searchObjects<Pipe>(pipes,
-                        [rep](const Pipe& p){ return p.isRepair() == (rep != 0); });
+                    lastSearch = displayFound(pipes, store.whereRepair(rep != 0));
+                } else if (filter == 3) {
+                    // critères combinés ; -1 = pas de contrainte
+                    PipeStore::Query q;
+                    int dMin, dMax, rep;
+                    float lMin, lMax;
+                    std::cout << "Min diameter (-1 = any): ";     std::cin >> dMin;
+                    std::cout << "Max diameter (-1 = any): ";     std::cin >> dMax;
+                    std::cout << "Min length (-1 = any): ";       std::cin >> lMin;
+                    std::cout << "Max length (-1 = any): ";       std::cin >> lMax;
+                    std::cout << "Repair status (0/1, -1 = any): "; std::cin >> rep;
+                    if (std::cin.fail()) {
+                        std::cin.clear();
+                        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                        std::cout << "Invalid input.\n";
+                        break;
+                    }
+                    if (dMin >= 0) q.minDiameter = dMin;
+                    if (dMax >= 0) q.maxDiameter = dMax;
+                    if (lMin >= 0) q.minLength = lMin;
+                    if (lMax >= 0) q.maxLength = lMax;
+                    if (rep == 0 || rep == 1) q.repair = rep;
+                    lastSearch = displayFound(pipes, store.select(q));
+                } else if (filter == 4 || filter == 5) {
+                    std::string text;
+                    std::cout << "Enter text (case ignored): ";
+                    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                    std::getline(std::cin, text);
+                    lastSearch = displayFound(pipes, filter == 4 ? store.whereNamePrefix(text)
+                                                                 : store.whereNameContains(text));
                 } else {
                     std::cout << "Invalid filter.\n";
                     break;
@@ -161,12 +220,13 @@ void managePipes(std::unordered_map<int, Pipe>& pipes, GasNetwork& network) {
                                 int id; std::cout << "Enter ID to edit: "; std::cin >> id;
                                 if (pipes.count(id)) {
                                     pipes[id].editRepair();
+                                    store.setRepair(id, pipes[id].isRepair());
                                     Logger::logAction("EDIT PIPE", id, pipes[id].getName(),
                                                      pipes[id].getLength(),
                                                      pipes[id].getDiameter(),
                                                      pipes[id].isRepair());
                                     if (network.isPipeInNetwork(id))
-                                        network.updatePipeInNetwork(id, pipes[id]);
+                                        network.updatePipeInNetwork(id);
                                 } else std::cout << "Not found.\n";
                                 break;
                             }
@@ -184,12 +244,14 @@ void managePipes(std::unordered_map<int, Pipe>& pipes, GasNetwork& network) {
                                                      pipes[id].getDiameter(),
                                                      pipes[id].isRepair());
                                     pipes.erase(id);
+                                    store.erase(id);
+                                    network.updatePipeInNetwork(id);
                                     std::cout << "Deleted.\n";
                                 } else std::cout << "Not found.\n";
                                 break;
                             }
                             case 4:
-                                batchEditPipes(pipes, lastSearch, network);
+                                batchEditPipes(pipes, store, lastSearch, network);
                                 break;
                             case 0: break;
                             default: std::cout << "Invalid.\n";
@@ -221,10 +283,10 @@ Pipe::Pipe(int id_, const std::string& name_, float length_,
            int diameter_, bool repair_)
     : id(id_), name(name_), length(length_), diameter(diameter_), repair(repair_) {}
 
-Pipe::Pipe() : id(0), name(""), length(0.0f), diameter(0), repair(false) {}
+Pipe::Pipe() : id(0), name(), length(0.0f), diameter(0), repair(false) {}
 
 int Pipe::getId() const { return id; }
-const std::string& Pipe::getName() const { return name; }
+const std::string& Pipe::getName() const { return name.str(); }
 float Pipe::getLength() const { return length; }
 int Pipe::getDiameter() const { return diameter; }
 bool Pipe::isRepair() const { return repair; }
@@ -257,7 +319,9 @@ void Pipe::input(int newId) {
     std::cout << "Enter the informations of pipe in this order:\n"
                  "name, length, diameter, repair (0 for no, 1 for yes)\n";
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    std::cout << "Name: "; std::getline(std::cin, name);
+    std::string text;
+    std::cout << "Name: "; std::getline(std::cin, text);
+    name = text;
     while (true) {
         std::cout << "Length: ";
         if (std::cin >> length && length >= 0) break;
@@ -310,8 +374,10 @@ std::ostream& operator<<(std::ostream& os, const Pipe& p) {
     return os;
 }
 std::istream& operator>>(std::istream& is, Pipe& p) {
+    std::string text;
     is >> p.id; is.ignore();
-    std::getline(is, p.name, '\t');
+    std::getline(is, text, '\t');
+    p.name = text;
     is >> p.length; is.ignore();
     is >> p.diameter; is.ignore();
     is >> p.repair; is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
@@ -6,13 +6,16 @@
 #include <unordered_map>
 #include <functional>
 #include <limits>
+#include "StringPool.h"
 
 class GasNetwork;   // forward declaration (pas besoin d’inclure ici)
+class PipeStore;
+class IdAllocator;
 
 class Pipe {
 private:
     int    id;
-    std::string name;
+    PooledString name;  // handle vers le pool (le texte n'est pas copié)
     float  length;    // en mètres
     int    diameter;  // en millimètres (500, 700, 1000, 1400)
     bool   repair;   // true = en réparation (indisponible)
@@ -31,6 +34,7 @@ public:
     // ----- getters / setters ---------------------------------------------
     int          getId() const;
     const std::string& getName() const;
+    StringPool::Handle getNameHandle() const { return name.handle(); }
     float        getLength() const;
     int          getDiameter() const;
     bool         isRepair() const;
@@ -57,9 +61,12 @@ public:
 // ---------------------------------------------------------------------
 //  Fonctions utilitaires (déclarées ici, définies dans Pipe.cpp)
 // ---------------------------------------------------------------------
-int addPipe(std::unordered_map<int, Pipe>& pipes);
-void managePipes(std::unordered_map<int, Pipe>& pipes, GasNetwork& network);
-void batchEditPipes(std::unordered_map<int, Pipe>& pipes,
+int addPipe(std::unordered_map<int, Pipe>& pipes, IdAllocator& ids);
+int addPipe(std::unordered_map<int, Pipe>& pipes, IdAllocator& ids, const std::string& name,
+            float length, int diameter, bool repair);   // sans saisie
+void managePipes(std::unordered_map<int, Pipe>& pipes, PipeStore& store,
+                 GasNetwork& network);
+void batchEditPipes(std::unordered_map<int, Pipe>& pipes, PipeStore& store,
                    const std::vector<int>& ids, GasNetwork& network);
 
 template<typename T>
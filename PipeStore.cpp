@@ -0,0 +1,331 @@
+#include "PipeStore.h"
+#include <algorithm>
+#include "TaskScheduler.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+const std::size_t BLOCK              = 64;
+const std::size_t PARALLEL_MIN_ROWS  = std::size_t(1) << 16;   // en dessous : un seul thread
+const std::size_t MIN_BLOCKS_PER_JOB = 256;
+
+unsigned configuredThreads = 0;
+
+unsigned threadCount() {
+    return configuredThreads ? configuredThreads : TaskScheduler::shared().threadCount();
+}
+
+inline unsigned lowestBit(std::uint64_t m) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(m));
+#else
+    unsigned i = 0;
+    while (!(m & 1)) { m >>= 1; ++i; }
+    return i;
+#endif
+}
+
+inline std::uint64_t validMask(std::size_t n) {
+    return n >= 64 ? ~std::uint64_t(0) : ((std::uint64_t(1) << n) - 1);
+}
+
+/* ---------------------------------------------------------------------
+   Noyaux : bit j du résultat = lo <= v[j] <= hi, pour j < n (n <= 64)
+   --------------------------------------------------------------------- */
+std::uint64_t rangeMask(const int* v, std::size_t n, int lo, int hi) {
+    std::uint64_t mask = 0;
+    std::size_t j = 0;
+#if defined(__AVX2__)
+    const __m256i vlo = _mm256_set1_epi32(lo), vhi = _mm256_set1_epi32(hi);
+    for (; j + 8 <= n; j += 8) {
+        __m256i x   = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + j));
+        __m256i bad = _mm256_or_si256(_mm256_cmpgt_epi32(vlo, x), _mm256_cmpgt_epi32(x, vhi));
+        unsigned ok = ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(bad))) & 0xFFu;
+        mask |= std::uint64_t(ok) << j;
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i vlo = _mm_set1_epi32(lo), vhi = _mm_set1_epi32(hi);
+    for (; j + 4 <= n; j += 4) {
+        __m128i x   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + j));
+        __m128i bad = _mm_or_si128(_mm_cmplt_epi32(x, vlo), _mm_cmpgt_epi32(x, vhi));
+        unsigned ok = ~static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(bad))) & 0xFu;
+        mask |= std::uint64_t(ok) << j;
+    }
+#endif
+    for (; j < n; ++j)
+        mask |= std::uint64_t(v[j] >= lo && v[j] <= hi) << j;
+    return mask;
+}
+
+std::uint64_t rangeMask(const float* v, std::size_t n, float lo, float hi) {
+    std::uint64_t mask = 0;
+    std::size_t j = 0;
+#if defined(__AVX2__)
+    const __m256 vlo = _mm256_set1_ps(lo), vhi = _mm256_set1_ps(hi);
+    for (; j + 8 <= n; j += 8) {
+        __m256 x  = _mm256_loadu_ps(v + j);
+        __m256 ok = _mm256_and_ps(_mm256_cmp_ps(x, vlo, _CMP_GE_OQ), _mm256_cmp_ps(x, vhi, _CMP_LE_OQ));
+        mask |= std::uint64_t(static_cast<unsigned>(_mm256_movemask_ps(ok))) << j;
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128 vlo = _mm_set1_ps(lo), vhi = _mm_set1_ps(hi);
+    for (; j + 4 <= n; j += 4) {
+        __m128 x  = _mm_loadu_ps(v + j);
+        __m128 ok = _mm_and_ps(_mm_cmpge_ps(x, vlo), _mm_cmple_ps(x, vhi));
+        mask |= std::uint64_t(static_cast<unsigned>(_mm_movemask_ps(ok))) << j;
+    }
+#endif
+    for (; j < n; ++j)
+        mask |= std::uint64_t(v[j] >= lo && v[j] <= hi) << j;
+    return mask;
+}
+
+}
+
+/*======================================================================
+   MAINTENANCE
+======================================================================*/
+void PipeStore::setThreadCount(unsigned n) { configuredThreads = n; }
+
+void PipeStore::clear() {
+    ids.clear(); lengths.clear(); diameters.clear(); repairBits.clear();
+    names.clear();
+    rowOf.clear();
+    byName.clear();
+    byDiameter.clear();
+    nameSearch.clear();
+    idAllocator.clear();
+}
+
+void PipeStore::assign(const std::unordered_map<int, Pipe>& pipes) {
+    clear();
+    ids.reserve(pipes.size());
+    lengths.reserve(pipes.size());
+    diameters.reserve(pipes.size());
+    names.reserve(pipes.size());
+    rowOf.reserve(pipes.size());
+    std::vector<std::pair<int, std::string>> texts;
+    texts.reserve(pipes.size());
+    bulkLoading = true;
+    for (const auto& kv : pipes) {
+        upsert(kv.second);
+        texts.push_back(std::make_pair(kv.first, kv.second.getName()));
+    }
+    bulkLoading = false;
+    for (auto& kv : byName)     std::sort(kv.second.begin(), kv.second.end());
+    for (auto& kv : byDiameter) std::sort(kv.second.begin(), kv.second.end());
+    nameSearch.assign(texts);
+}
+
+void PipeStore::setRepairBit(std::size_t row, bool r) {
+    std::uint64_t bit = std::uint64_t(1) << (row % 64);
+    if (r) repairBits[row / 64] |= bit;
+    else   repairBits[row / 64] &= ~bit;
+}
+
+bool PipeStore::repairBit(std::size_t row) const {
+    return (repairBits[row / 64] >> (row % 64)) & 1u;
+}
+
+// listes d'IDs triées : les nouveaux IDs arrivent presque toujours en fin
+template<typename Key, typename Index>
+static void addSorted(Index& index, const Key& key, int id) {
+    std::vector<int>& list = index[key];
+    if (list.empty() || list.back() < id) list.push_back(id);
+    else list.insert(std::lower_bound(list.begin(), list.end(), id), id);
+}
+
+template<typename Key, typename Index>
+static void removeSorted(Index& index, const Key& key, int id) {
+    auto it = index.find(key);
+    if (it == index.end()) return;
+    std::vector<int>& list = it->second;
+    auto pos = std::lower_bound(list.begin(), list.end(), id);
+    if (pos != list.end() && *pos == id) list.erase(pos);
+    if (list.empty()) index.erase(it);
+}
+
+void PipeStore::upsert(const Pipe& pipe) {
+    auto it = rowOf.find(pipe.getId());
+    StringPool::Handle name = pipe.getNameHandle();
+    std::size_t row;
+    if (it == rowOf.end()) {
+        row = ids.size();
+        rowOf.emplace(pipe.getId(), row);
+        idAllocator.reserve(pipe.getId());
+        ids.push_back(pipe.getId());
+        lengths.push_back(0.0f);
+        diameters.push_back(0);
+        names.push_back(name);
+        if (row / 64 >= repairBits.size()) repairBits.push_back(0);
+        if (bulkLoading) {               // listes triées une seule fois par assign
+            byName[name].push_back(pipe.getId());
+            byDiameter[pipe.getDiameter()].push_back(pipe.getId());
+        } else {
+            addSorted(byName, name, pipe.getId());
+            addSorted(byDiameter, pipe.getDiameter(), pipe.getId());
+            nameSearch.upsert(pipe.getId(), pipe.getName());
+        }
+    } else {
+        row = it->second;
+        if (names[row] != name) {        // même texte <=> même handle
+            removeSorted(byName, names[row], pipe.getId());
+            addSorted(byName, name, pipe.getId());
+            nameSearch.upsert(pipe.getId(), pipe.getName());
+            names[row] = name;
+        }
+        if (diameters[row] != pipe.getDiameter()) {
+            removeSorted(byDiameter, diameters[row], pipe.getId());
+            addSorted(byDiameter, pipe.getDiameter(), pipe.getId());
+        }
+    }
+    lengths[row]   = pipe.getLength();
+    diameters[row] = pipe.getDiameter();
+    setRepairBit(row, pipe.isRepair());
+}
+
+void PipeStore::setRepair(int id, bool repair) {
+    auto it = rowOf.find(id);
+    if (it != rowOf.end()) setRepairBit(it->second, repair);
+}
+
+// suppression par échange avec la dernière ligne (O(1))
+void PipeStore::erase(int id) {
+    auto it = rowOf.find(id);
+    if (it == rowOf.end()) return;
+    std::size_t row = it->second, last = ids.size() - 1;
+    rowOf.erase(it);
+    idAllocator.release(id);
+    removeSorted(byName, names[row], id);
+    removeSorted(byDiameter, diameters[row], id);
+    nameSearch.erase(id);
+    if (row != last) {
+        ids[row]       = ids[last];
+        lengths[row]   = lengths[last];
+        diameters[row] = diameters[last];
+        names[row]     = names[last];
+        setRepairBit(row, repairBit(last));
+        rowOf[ids[row]] = row;
+    }
+    setRepairBit(last, false);
+    ids.pop_back(); lengths.pop_back(); diameters.pop_back(); names.pop_back();
+    if (repairBits.size() > (ids.size() + 63) / 64) repairBits.pop_back();
+}
+
+/*======================================================================
+   FILTRES
+======================================================================*/
+std::uint64_t PipeStore::blockMask(std::size_t block, const Query& q) const {
+    std::size_t base = block * BLOCK;
+    std::size_t n    = std::min(BLOCK, ids.size() - base);
+    std::uint64_t mask = validMask(n);
+
+    if (q.repair >= 0)
+        mask &= q.repair ? repairBits[block] : ~repairBits[block];
+    if (mask && (q.minDiameter != std::numeric_limits<int>::min() ||
+                 q.maxDiameter != std::numeric_limits<int>::max()))
+        mask &= rangeMask(&diameters[base], n, q.minDiameter, q.maxDiameter);
+    if (mask && (q.minLength > -std::numeric_limits<float>::infinity() ||
+                 q.maxLength <  std::numeric_limits<float>::infinity()))
+        mask &= rangeMask(&lengths[base], n, q.minLength, q.maxLength);
+    return mask;
+}
+
+// même prédicat que blockMask, pour une ligne isolée (candidats d'un index)
+bool PipeStore::rowMatches(std::size_t row, const Query& q) const {
+    return (q.repair < 0 || repairBit(row) == (q.repair != 0)) &&
+           diameters[row] >= q.minDiameter && diameters[row] <= q.maxDiameter &&
+           lengths[row]   >= q.minLength   && lengths[row]   <= q.maxLength;
+}
+
+void PipeStore::selectBlocks(std::size_t first, std::size_t last, const Query& q,
+                             std::vector<int>& out) const {
+    for (std::size_t b = first; b < last; ++b) {
+        std::uint64_t m = blockMask(b, q);
+        while (m) {
+            out.push_back(ids[b * BLOCK + lowestBit(m)]);
+            m &= m - 1;
+        }
+    }
+}
+
+std::vector<int> PipeStore::select(const Query& q) const {
+    std::vector<int> found;
+    if (q.matchName) {                       // index sur le nom, puis vérification
+        StringPool::Handle name;
+        if (!StringPool::find(q.name, name)) return found;
+        auto it = byName.find(name);
+        if (it == byName.end()) return found;
+        for (int id : it->second)
+            if (rowMatches(rowOf.at(id), q)) found.push_back(id);
+        return found;
+    }
+
+    std::size_t blocks = (ids.size() + BLOCK - 1) / BLOCK;
+    unsigned threads = threadCount();
+    std::size_t jobs = std::min<std::size_t>(threads, blocks / MIN_BLOCKS_PER_JOB);
+
+    if (ids.size() < PARALLEL_MIN_ROWS || jobs < 2) {
+        selectBlocks(0, blocks, q, found);
+    } else {
+        std::vector<std::vector<int>> parts(jobs);
+        std::size_t per = (blocks + jobs - 1) / jobs;
+        TaskScheduler::shared().parallelFor(0, jobs, 1, [&](std::size_t first, std::size_t last) {
+            for (std::size_t t = first; t < last; ++t)
+                selectBlocks(t * per, std::min(blocks, (t + 1) * per), q, parts[t]);
+        });
+
+        std::size_t total = 0;
+        for (const auto& p : parts) total += p.size();
+        found.reserve(total);
+        for (const auto& p : parts) found.insert(found.end(), p.begin(), p.end());
+    }
+    if (!std::is_sorted(found.begin(), found.end())) std::sort(found.begin(), found.end());
+    return found;
+}
+
+std::vector<int> PipeStore::whereRepair(bool repair) const {
+    Query q;
+    q.repair = repair ? 1 : 0;
+    return select(q);
+}
+
+std::vector<int> PipeStore::whereDiameter(int minDiameter, int maxDiameter) const {
+    std::vector<int> found;
+    if (minDiameter > maxDiameter) return found;
+    auto first = byDiameter.lower_bound(minDiameter);
+    auto last  = byDiameter.upper_bound(maxDiameter);
+    for (auto it = first; it != last; ++it) {        // fusion des seaux déjà triés
+        std::size_t middle = found.size();
+        found.insert(found.end(), it->second.begin(), it->second.end());
+        std::inplace_merge(found.begin(), found.begin() + middle, found.end());
+    }
+    return found;
+}
+
+std::vector<int> PipeStore::whereLength(float minLength, float maxLength) const {
+    Query q;
+    q.minLength = minLength;
+    q.maxLength = maxLength;
+    return select(q);
+}
+
+std::vector<int> PipeStore::whereName(const std::string& name) const {
+    StringPool::Handle h;
+    if (!StringPool::find(name, h)) return std::vector<int>();   // nom jamais vu
+    auto it = byName.find(h);
+    return it == byName.end() ? std::vector<int>() : it->second;
+}
+
+std::vector<int> PipeStore::whereNamePrefix(const std::string& text) const {
+    return nameSearch.prefix(text);
+}
+
+std::vector<int> PipeStore::whereNameContains(const std::string& text) const {
+    return nameSearch.contains(text);
+}
@@ -0,0 +1,98 @@
+// PipeStore.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "IdAllocator.h"
+#include "Pipe.h"
+#include "TrigramIndex.h"
+
+// ---------------------------------------------------------------------
+//  Stockage en colonnes des tuyaux (struct-of-arrays) pour les filtres.
+//
+//  Une ligne par tuyau : id, longueur, diamètre, bit « réparation » et
+//  handle du nom dans le StringPool (pas de copie du texte). Les filtres
+//  travaillent par blocs de 64 lignes et produisent un masque 64 bits :
+//  comparaisons SIMD (SSE2, AVX2 si compilé avec -mavx2) sur les colonnes,
+//  bitmap de réparation utilisée telle quelle. Au-delà d'un certain nombre
+//  de lignes, les blocs sont répartis sur le TaskScheduler partagé.
+//
+//  Index secondaires tenus à jour avec les colonnes : hachage sur le nom,
+//  seaux par diamètre et trigrammes du nom (préfixe / sous-chaîne). Les
+//  recherches par nom et par plage de diamètre coûtent O(log n + k) au
+//  lieu d'un parcours de la table.
+//
+//  Les résultats sont des vecteurs d'IDs triés, sans aucun affichage.
+//  La table doit être tenue à jour par l'appelant (assign / upsert / erase) ;
+//  elle tient elle-même l'allocateur d'IDs des tuyaux (allocator()).
+// ---------------------------------------------------------------------
+class PipeStore {
+public:
+    // Filtre combiné : les critères laissés à leur valeur par défaut sont ignorés
+    struct Query {
+        int         repair      = -1;                                  // -1 : indifférent
+        int         minDiameter = std::numeric_limits<int>::min();
+        int         maxDiameter = std::numeric_limits<int>::max();
+        float       minLength   = -std::numeric_limits<float>::infinity();
+        float       maxLength   =  std::numeric_limits<float>::infinity();
+        bool        matchName   = false;
+        std::string name;                                              // égalité exacte
+    };
+
+private:
+    std::vector<int>                ids;
+    std::vector<float>              lengths;
+    std::vector<int>                diameters;
+    std::vector<std::uint64_t>      repairBits;      // 1 bit par ligne
+    std::vector<StringPool::Handle> names;
+    std::unordered_map<int, std::size_t> rowOf;      // id → ligne
+
+    std::unordered_map<StringPool::Handle, std::vector<int>> byName;      // IDs triés par nom
+    std::map<int, std::vector<int>>                          byDiameter;  // IDs triés par diamètre
+    TrigramIndex                                             nameSearch;
+    IdAllocator                                              idAllocator;
+    bool                                                     bulkLoading = false;  // assign en cours
+
+    bool rowMatches(std::size_t row, const Query& q) const;
+
+    void setRepairBit(std::size_t row, bool r);
+    bool repairBit(std::size_t row) const;
+
+    std::uint64_t blockMask(std::size_t block, const Query& q) const;
+    void selectBlocks(std::size_t first, std::size_t last, const Query& q,
+                      std::vector<int>& out) const;
+
+public:
+    PipeStore() {}
+    explicit PipeStore(const std::unordered_map<int, Pipe>& pipes) { assign(pipes); }
+
+    // ----- maintenance ---------------------------------------------------
+    void assign(const std::unordered_map<int, Pipe>& pipes);
+    void upsert(const Pipe& pipe);
+    void setRepair(int id, bool repair);
+    void erase(int id);
+    void clear();
+
+    std::size_t size() const { return ids.size(); }
+    bool contains(int id) const { return rowOf.count(id) != 0; }
+
+    // IDs occupés = lignes de la table ; addPipe y prend le prochain ID
+    IdAllocator& allocator() { return idAllocator; }
+
+    // ----- filtres (IDs triés) -------------------------------------------
+    std::vector<int> select(const Query& q) const;
+    std::vector<int> whereRepair(bool repair) const;                       // bitmap
+    std::vector<int> whereDiameter(int minDiameter, int maxDiameter) const; // seaux
+    std::vector<int> whereLength(float minLength, float maxLength) const;   // SIMD
+    std::vector<int> whereName(const std::string& name) const;             // hachage
+    std::vector<int> whereNamePrefix(const std::string& text) const;       // trigrammes,
+    std::vector<int> whereNameContains(const std::string& text) const;     // sans casse
+
+    // Nombre de parts de travail de select sur le TaskScheduler partagé
+    // (0 = une par worker)
+    static void setThreadCount(unsigned n);
+};
@@ -0,0 +1,390 @@
+#include "QueryServer.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+QueryServer* activeServer = nullptr;                   // cible de SIGINT / SIGTERM
+
+void onSignal(int) {
+    if (activeServer) activeServer->stop();
+}
+
+inline bool isError(const std::string& answer) {
+    return answer.compare(0, 11, "{\"ok\":false") == 0;
+}
+
+// chaîne JSON entre guillemets (guillemets, barres obliques inverses et
+// caractères de contrôle échappés)
+void appendJsonString(std::string& out, const std::string& text) {
+    out += '"';
+    for (char ch : text) {
+        unsigned char u = static_cast<unsigned char>(ch);
+        if (ch == '"' || ch == '\\') { out += '\\'; out += ch; }
+        else if (u < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", u);
+            out += escaped;
+        }
+        else out += ch;
+    }
+    out += '"';
+}
+}
+
+/*======================================================================
+   CONSTRUCTION / FERMETURE
+======================================================================*/
+QueryServer::QueryServer(CommandProcessor& processor_, GasNetwork& network_, unsigned workers_)
+    : processor(processor_), network(network_), pool(workers_), analyses(pool), stopRequested(false) {
+#if defined(__linux__)
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    epoll_event ev;
+    ev.events  = EPOLLIN;
+    ev.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+#endif
+}
+
+QueryServer::~QueryServer() {
+#if defined(__linux__)
+    while (!connections.empty()) close(connections.begin()->first);
+    for (int fd : listenFds) ::close(fd);
+    if (!unixPath.empty()) unlink(unixPath.c_str());
+    if (wakeFd >= 0) ::close(wakeFd);
+    if (epollFd >= 0) ::close(epollFd);
+#endif
+}
+
+void QueryServer::stop() {
+    stopRequested = true;
+#if defined(__linux__)
+    std::uint64_t one = 1;
+    if (wakeFd >= 0 && write(wakeFd, &one, sizeof(one)) < 0) {}   // réveille epoll_wait
+#endif
+}
+
+#if defined(__linux__)
+
+/*======================================================================
+   ÉCOUTE
+======================================================================*/
+bool QueryServer::addListener(int fd) {
+    if (listen(fd, 128) < 0) { ::close(fd); return false; }
+    epoll_event ev;
+    ev.events  = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    listenFds.push_back(fd);
+    return true;
+}
+
+bool QueryServer::listenUnix(const std::string& path) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    unlink(path.c_str());                              // socket laissée par un arrêt brutal
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) { ::close(fd); return false; }
+    unixPath = path;
+    return addListener(fd);
+}
+
+bool QueryServer::listenTcp(int port) {
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(static_cast<unsigned short>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) { ::close(fd); return false; }
+    return addListener(fd);
+}
+
+void QueryServer::accept(int listenFd) {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;                            // EAGAIN : plus de client en attente
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));   // échoue sans effet (Unix)
+        std::uint64_t id = nextConnection++;
+        Connection& c = connections[id];
+        c.fd = fd;
+        c.id = id;
+        c.interest = EPOLLIN;
+        connectionOf[fd] = id;
+        epoll_event ev;
+        ev.events  = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+void QueryServer::close(std::uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    ::close(it->second.fd);
+    connectionOf.erase(it->second.fd);
+    connections.erase(it);                             // jobs encore en cours : réponse ignorée
+}
+
+/*======================================================================
+   LECTURE / ÉCRITURE
+======================================================================*/
+void QueryServer::readFrom(std::uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& c = it->second;
+    char buffer[65536];
+    while (true) {
+        ssize_t n = recv(c.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) { c.in.append(buffer, static_cast<std::size_t>(n)); continue; }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) c.peerClosed = true;
+        if (n < 0 && errno == EINTR) continue;
+        break;
+    }
+    processInput(id);
+}
+
+// Lignes complètes → requêtes, dans la limite de MAX_IN_FLIGHT ; puis envoi
+void QueryServer::processInput(std::uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& c = it->second;
+    std::size_t pos = 0;
+    while (c.nextSeq - c.nextOut < MAX_IN_FLIGHT) {
+        std::size_t eol = c.in.find('\n', pos);
+        if (eol == std::string::npos) break;
+        std::string line = c.in.substr(pos, eol - pos);
+        pos = eol + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.find_first_not_of(" \t") == std::string::npos) continue;
+        handleLine(c, line, Clock::now());
+    }
+    c.in.erase(0, pos);
+    if (c.in.size() > MAX_LINE && c.in.find('\n') == std::string::npos) {
+        c.out += "{\"ok\":false,\"error\":\"line too long\"}\n";
+        c.in.clear();
+        c.peerClosed = true;
+    }
+    if (!flush(c)) { close(id); return; }
+    bool idle = c.nextSeq == c.nextOut && c.out.empty();
+    if (c.peerClosed && idle && c.in.find('\n') == std::string::npos) close(id);
+}
+
+bool QueryServer::flush(Connection& c) {
+    while (!c.out.empty()) {
+        ssize_t n = send(c.fd, c.out.data(), c.out.size(), MSG_NOSIGNAL);
+        if (n > 0) { c.out.erase(0, static_cast<std::size_t>(n)); continue; }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return false;                                  // client parti
+    }
+    // intérêt epoll : écriture tant qu'il reste à envoyer ; lecture coupée
+    // après la fin du client ou quand MAX_IN_FLIGHT est atteint (le client
+    // est alors freiné par TCP / la socket au lieu de remplir c.in)
+    std::uint32_t interest = c.out.empty() ? 0 : static_cast<std::uint32_t>(EPOLLOUT);
+    if (!c.peerClosed && c.nextSeq - c.nextOut < MAX_IN_FLIGHT) interest |= EPOLLIN;
+    if (interest != c.interest) {
+        epoll_event ev;
+        ev.events  = interest;
+        ev.data.fd = c.fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+        c.interest = interest;
+    }
+    return true;
+}
+
+/*======================================================================
+   REQUÊTES
+======================================================================*/
+void QueryServer::handleLine(Connection& c, const std::string& line, Clock::time_point received) {
+    std::uint64_t seq = c.nextSeq++;
+    std::string kind = CommandProcessor::commandOf(line);
+    std::string answer;
+    if (kind == "stats") {
+        answer = statsJson();
+    } else if (kind == "shortest_path" || kind == "max_flow") {
+        std::shared_ptr<Job> job = std::make_shared<Job>();   // version courante
+        job->conn     = c.id;
+        job->seq      = seq;
+        job->line     = line;
+        job->kind     = kind;
+        job->received = received;
+        job->snapshot = network.snapshot();
+        analyses.run([this, job] { analyze(*job); });
+        return;
+    } else {
+        processor.execute(line, answer);               // thread écrivain
+        network.publish();                             // sans effet si rien n'a changé
+        // une entrée de stats par commande connue : le client ne choisit pas les clés
+        if (kind.empty()) kind = "invalid";
+        else if (!CommandProcessor::isCommand(kind)) kind = "unknown";
+    }
+    record(kind, received, answer);
+    deliver(c, seq, answer);
+}
+
+void QueryServer::record(const std::string& kind, Clock::time_point received,
+                         const std::string& answer) {
+    CommandStats& s = stats[kind];
+    ++s.count;
+    if (isError(answer)) ++s.errors;
+    if (s.window.count() >= STATS_WINDOW) s.window.clear();
+    s.window.add(received, Clock::now());
+}
+
+// Réponse seq de c : envoyée si c'est la suivante attendue, sinon gardée
+void QueryServer::deliver(Connection& c, std::uint64_t seq, std::string& answer) {
+    if (seq != c.nextOut) { c.ready[seq].swap(answer); return; }
+    c.out += answer;
+    ++c.nextOut;
+    for (auto it = c.ready.begin(); it != c.ready.end() && it->first == c.nextOut; it = c.ready.erase(it)) {
+        c.out += it->second;
+        ++c.nextOut;
+    }
+}
+
+void QueryServer::drainDone() {
+    std::uint64_t counter;
+    while (read(wakeFd, &counter, sizeof(counter)) > 0) {}
+    std::vector<Job> finished;
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        finished.swap(done);
+    }
+    std::vector<std::uint64_t> touched;
+    for (Job& job : finished) {
+        record(job.kind, job.received, job.answer);
+        auto it = connections.find(job.conn);
+        if (it == connections.end()) continue;         // client parti entre-temps
+        deliver(it->second, job.seq, job.answer);
+        touched.push_back(job.conn);
+    }
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (std::uint64_t id : touched) processInput(id);   // reprend les lignes en attente
+}
+
+void QueryServer::analyze(Job& job) {
+    if (!job.snapshot) job.answer = "{\"ok\":false,\"error\":\"network not published\"}\n";
+    else try {
+        CommandProcessor::answerQuery(*job.snapshot, job.line, job.answer);
+    } catch (const std::exception&) {                  // mémoire : la requête échoue, pas le serveur
+        job.answer = "{\"ok\":false,\"error\":\"internal error\"}\n";
+    }
+    job.snapshot.reset();                              // libère la version au plus tôt
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        done.push_back(std::move(job));
+    }
+    std::uint64_t one = 1;
+    if (write(wakeFd, &one, sizeof(one)) < 0) {}
+}
+
+/*======================================================================
+   STATISTIQUES
+======================================================================*/
+std::string QueryServer::statsJson() {
+    double uptime = std::chrono::duration<double>(Clock::now() - started).count();
+    std::uint64_t total = 0;
+    std::string body;
+    char buffer[256];
+    for (auto& kv : stats) {
+        CommandStats& s = kv.second;
+        total += s.count;
+        if (!body.empty()) body += ',';
+        appendJsonString(body, kv.first);
+        std::snprintf(buffer, sizeof(buffer),
+                      ":{\"count\":%llu,\"errors\":%llu,\"qps\":%.1f,"
+                      "\"median_us\":%.1f,\"p99_us\":%.1f,\"max_us\":%.1f}",
+                      static_cast<unsigned long long>(s.count),
+                      static_cast<unsigned long long>(s.errors),
+                      uptime > 0 ? s.count / uptime : 0.0,
+                      s.window.median() / 1e3, s.window.percentile(99) / 1e3, s.window.max() / 1e3);
+        body += buffer;
+    }
+    std::snprintf(buffer, sizeof(buffer),
+                  "{\"ok\":true,\"uptime_s\":%.1f,\"connections\":%zu,\"workers\":%u,"
+                  "\"version\":%llu,\"strings\":%zu,\"string_bytes\":%zu,"
+                  "\"requests\":%llu,\"qps\":%.1f,\"commands\":{",
+                  uptime, connections.size(), pool.threadCount(),
+                  static_cast<unsigned long long>(network.getVersion()),
+                  StringPool::size(), StringPool::bytes(),
+                  static_cast<unsigned long long>(total), uptime > 0 ? total / uptime : 0.0);
+    return buffer + body + "}}\n";
+}
+
+/*======================================================================
+   BOUCLE PRINCIPALE
+======================================================================*/
+bool QueryServer::run() {
+    if (epollFd < 0 || wakeFd < 0 || listenFds.empty()) return false;
+    started = Clock::now();
+    network.publish();
+
+    activeServer = this;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    epoll_event events[64];
+    while (!stopRequested) {
+        int n = epoll_wait(epollFd, events, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wakeFd) { drainDone(); continue; }
+            if (std::find(listenFds.begin(), listenFds.end(), fd) != listenFds.end()) { accept(fd); continue; }
+            auto owner = connectionOf.find(fd);
+            if (owner == connectionOf.end()) continue;          // fermée plus haut dans ce lot
+            std::uint64_t id = owner->second;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) readFrom(id);
+            auto it = connections.find(id);
+            if (it != connections.end() && (events[i].events & EPOLLOUT)) {
+                if (!flush(it->second)) close(id);
+                else processInput(id);
+            }
+        }
+    }
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    activeServer = nullptr;
+    analyses.wait();                                   // réponses non envoyées : abandonnées
+    return true;
+}
+
+#else   // pas d'epoll : mode serveur indisponible
+
+bool QueryServer::listenUnix(const std::string&) { return false; }
+bool QueryServer::listenTcp(int) { return false; }
+bool QueryServer::run() { return false; }
+
+#endif
@@ -0,0 +1,125 @@
+// QueryServer.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CommandProcessor.h"
+#include "GasNetwork.h"
+#include "GraphSnapshot.h"
+#include "LatencyStats.h"
+#include "TaskScheduler.h"
+
+// ---------------------------------------------------------------------
+//  Service de requêtes local (main --serve) : réseau chargé une fois,
+//  interrogé par plusieurs outils via une socket Unix ou un port TCP
+//  sur 127.0.0.1. Protocole = celui de --batch (CommandProcessor) : une
+//  commande JSON par ligne, une réponse par ligne, plus
+//    {"cmd":"stats"}    compteurs par commande (nombre, QPS, latences) ;
+//                       commandes inconnues sous "unknown", lignes
+//                       illisibles sous "invalid" ; taille du StringPool
+//                       ("strings", "string_bytes"), qui ne décroît pas
+//
+//  Boucle epoll (Linux) sur un seul thread, qui est aussi l'unique
+//  écrivain : modifications et recherches (index en mémoire, rapides)
+//  y sont exécutées directement, puis le réseau est republié. Les
+//  analyses (shortest_path, max_flow) partent vers un TaskScheduler
+//  avec la GraphSnapshot courante : elles ne bloquent ni la boucle ni
+//  les écritures qui suivent.
+//
+//  Pipelining : un client peut envoyer plusieurs lignes sans attendre ;
+//  les réponses repartent dans l'ordre des requêtes de sa connexion
+//  (numéro de séquence par requête). Au-delà de MAX_IN_FLIGHT requêtes
+//  sans réponse, les lignes suivantes attendent dans le tampon d'entrée.
+//
+//  Latence mesurée de la lecture de la ligne à la réponse prête ; les
+//  percentiles portent sur une fenêtre glissante par commande.
+// ---------------------------------------------------------------------
+class QueryServer {
+public:
+    static const std::size_t MAX_IN_FLIGHT = 1024;          // par connexion
+    static const std::size_t MAX_LINE      = 1 << 20;       // octets
+    static const std::size_t STATS_WINDOW  = 1 << 16;       // échantillons
+
+private:
+    typedef LatencyStats::Clock Clock;
+
+    struct Connection {
+        int                                fd;
+        std::uint64_t                      id;
+        std::string                        in;          // octets reçus, lignes incomplètes
+        std::string                        out;         // réponses prêtes à envoyer
+        std::uint64_t                      nextSeq = 0;  // prochaine requête reçue
+        std::uint64_t                      nextOut = 0;  // prochaine réponse à envoyer
+        std::map<std::uint64_t, std::string> ready;     // réponses arrivées en avance
+        bool                               peerClosed = false;
+        std::uint32_t                      interest = 0;        // événements epoll armés
+    };
+
+    struct Job {                                       // analyse confiée à un worker
+        std::uint64_t                        conn;
+        std::uint64_t                        seq;
+        std::string                          line;
+        std::string                          kind;
+        Clock::time_point                    received;
+        std::shared_ptr<const GraphSnapshot> snapshot;
+        std::string                          answer;
+    };
+
+    struct CommandStats {
+        std::uint64_t count = 0;
+        std::uint64_t errors = 0;
+        LatencyStats  window;
+    };
+
+    CommandProcessor&  processor;
+    GasNetwork&        network;
+
+    int                epollFd = -1;
+    int                wakeFd = -1;                    // eventfd : jobs terminés / arrêt
+    std::vector<int>   listenFds;
+    std::string        unixPath;                       // supprimé à la fermeture
+
+    std::unordered_map<std::uint64_t, Connection> connections;
+    std::unordered_map<int, std::uint64_t>        connectionOf;   // fd → ID de connexion
+    std::uint64_t                                 nextConnection = 1;
+
+    // analyses en cours et résultats rendus à la boucle
+    std::mutex               doneMutex;
+    std::vector<Job>         done;
+    TaskScheduler            pool;
+    TaskScheduler::Group     analyses;               // attendues à la fin de run()
+    std::atomic<bool>        stopRequested;
+
+    std::map<std::string, CommandStats> stats;
+    Clock::time_point                   started;
+
+    bool addListener(int fd);
+    void accept(int listenFd);
+    void readFrom(std::uint64_t id);
+    void processInput(std::uint64_t id);               // peut fermer la connexion
+    void handleLine(Connection& c, const std::string& line, Clock::time_point received);
+    void record(const std::string& kind, Clock::time_point received, const std::string& answer);
+    void deliver(Connection& c, std::uint64_t seq, std::string& answer);
+    void drainDone();
+    bool flush(Connection& c);                         // false : client parti
+    void close(std::uint64_t id);
+    void analyze(Job& job);                            // thread du pool
+    std::string statsJson();
+
+public:
+    QueryServer(CommandProcessor& processor, GasNetwork& network, unsigned workers = 0);
+    ~QueryServer();
+
+    bool listenUnix(const std::string& path);
+    bool listenTcp(int port);                          // 127.0.0.1 uniquement
+
+    // Boucle jusqu'à stop() (ou SIGINT / SIGTERM) ; false si non supporté
+    bool run();
+    void stop();                                       // sûr depuis un autre thread / signal
+};
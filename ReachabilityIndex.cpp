@@ -0,0 +1,346 @@
+#include "ReachabilityIndex.h"
+#include <algorithm>
+
+/*======================================================================
+   NŒUDS
+======================================================================*/
+void ReachabilityIndex::clear() {
+    slotOf.clear();
+    kcOf.clear();
+    succ.clear();
+    pred.clear();
+    isSource.clear();
+    rank.clear();
+    lowRank   = 0;
+    highRank  = -1;
+    edgeCount = 0;
+    stamp.clear();
+    round = 0;
+    fresh = true;                                      // graphe vide : rien à étiqueter
+    chainOf.clear();
+    positionOf.clear();
+    chainHead.clear();
+    chainTail.clear();
+    labels.clear();
+    labelCount  = 0;
+    searchWork  = 0;
+    rebuildCost = 0;
+}
+
+int ReachabilityIndex::node(int kc_id) {
+    auto ins = slotOf.emplace(kc_id, static_cast<int>(kcOf.size()));
+    if (!ins.second) return ins.first->second;
+    kcOf.push_back(kc_id);
+    succ.emplace_back();
+    pred.emplace_back();
+    isSource.push_back(0);
+    rank.push_back(0);
+    stamp.push_back(0);
+    chainOf.push_back(-1);
+    positionOf.push_back(0);
+    labels.emplace_back();
+    return ins.first->second;
+}
+
+bool ReachabilityIndex::contains(int kc_id) const {
+    auto it = slotOf.find(kc_id);
+    return it != slotOf.end() && (isSource[it->second] || !pred[it->second].empty());
+}
+
+int ReachabilityIndex::nextRound() {
+    if (++round == 0) { std::fill(stamp.begin(), stamp.end(), 0); round = 1; }
+    return round;
+}
+
+/*======================================================================
+   ORDRE TOPOLOGIQUE DYNAMIQUE – Pearce & Kelly
+   Arête u → v avec rang(v) < rang(u) : descendants de v de rang < rang(u)
+   (atteindre u : cycle), ancêtres de u de rang > rang(v) ; les rangs de
+   ces deux zones sont redistribués, ancêtres d'abord.
+======================================================================*/
+bool ReachabilityIndex::reorder(int u, int v) {
+    const int lower = rank[v], upper = rank[u];
+    if (lower > upper) return true;                    // ordre déjà respecté
+
+    std::vector<int> forward, backward;
+    const int seenF = nextRound();
+    stack.assign(1, v);
+    stamp[v] = seenF;
+    while (!stack.empty()) {
+        int x = stack.back(); stack.pop_back();
+        forward.push_back(x);
+        for (int y : succ[x]) {
+            if (y == u) return false;                  // v atteint u
+            if (rank[y] < upper && stamp[y] != seenF) { stamp[y] = seenF; stack.push_back(y); }
+        }
+    }
+    const int seenB = nextRound();
+    stack.assign(1, u);
+    stamp[u] = seenB;
+    while (!stack.empty()) {
+        int x = stack.back(); stack.pop_back();
+        backward.push_back(x);
+        for (int y : pred[x])
+            if (rank[y] > lower && stamp[y] != seenB) { stamp[y] = seenB; stack.push_back(y); }
+    }
+
+    auto byRank = [this](int a, int b) { return rank[a] < rank[b]; };
+    std::sort(forward.begin(), forward.end(), byRank);
+    std::sort(backward.begin(), backward.end(), byRank);
+    std::vector<int> slots;
+    slots.reserve(forward.size() + backward.size());
+    for (int x : backward) slots.push_back(rank[x]);
+    for (int x : forward)  slots.push_back(rank[x]);
+    std::sort(slots.begin(), slots.end());
+    std::size_t k = 0;
+    for (int x : backward) rank[x] = slots[k++];
+    for (int x : forward)  rank[x] = slots[k++];
+    return true;
+}
+
+/*======================================================================
+   REQUÊTES
+======================================================================*/
+bool ReachabilityIndex::reaches(int from, int to) {
+    if (from == to) return true;
+    auto a = slotOf.find(from), b = slotOf.find(to);
+    if (a == slotOf.end() || b == slotOf.end()) return false;
+    const int x = a->second, y = b->second;
+    if (rank[x] > rank[y]) return false;               // l'ordre suffit
+
+    if (!fresh && searchWork >= rebuildCost) relabel();  // les recherches ont assez coûté
+    if (!fresh) return search(x, y);
+    return labelled(x, y);
+}
+
+bool ReachabilityIndex::excludes(int from, int to) const {
+    if (from == to) return false;
+    auto a = slotOf.find(from), b = slotOf.find(to);
+    if (a == slotOf.end() || b == slotOf.end()) return false;
+    const int x = a->second, y = b->second;
+    if (rank[x] > rank[y]) return true;
+    return fresh && !labelled(x, y);                   // sinon : il faudrait chercher
+}
+
+bool ReachabilityIndex::labelled(int x, int y) const {
+    const std::vector<Label>& row = labels[x];
+    const int chain = chainOf[y];
+    auto it = std::lower_bound(row.begin(), row.end(), chain,
+                               [](const Label& l, int c) { return l.chain < c; });
+    return it != row.end() && it->chain == chain && it->position <= positionOf[y];
+}
+
+// seuls les nœuds de rang inférieur à celui de « to » peuvent y mener
+bool ReachabilityIndex::search(int from, int to) {
+    const int limit = rank[to];
+    const int seen  = nextRound();
+    std::size_t work = 0;
+    bool found = false;
+    stack.assign(1, from);
+    stamp[from] = seen;
+    while (!stack.empty() && !found) {
+        int x = stack.back(); stack.pop_back();
+        work += 1 + succ[x].size();
+        for (int y : succ[x]) {
+            if (y == to) { found = true; break; }
+            if (rank[y] < limit && stamp[y] != seen) { stamp[y] = seen; stack.push_back(y); }
+        }
+    }
+    searchWork += work;
+    return found;
+}
+
+/*======================================================================
+   CHAÎNES ET ÉTIQUETTES
+======================================================================*/
+void ReachabilityIndex::openChain(int x) {
+    chainOf[x]    = static_cast<int>(chainTail.size());
+    positionOf[x] = 0;
+    chainHead.push_back(x);
+    chainTail.push_back(x);
+}
+
+void ReachabilityIndex::extendChain(int x, int after) {
+    chainOf[x]    = chainOf[after];
+    positionOf[x] = positionOf[after] + 1;
+    chainTail[chainOf[x]] = x;
+}
+
+// positions négatives admises : seul l'ordre dans la chaîne compte
+void ReachabilityIndex::prependChain(int x, int before) {
+    chainOf[x]    = chainOf[before];
+    positionOf[x] = positionOf[before] - 1;
+    chainHead[chainOf[x]] = x;
+}
+
+bool ReachabilityIndex::merge(int x, const std::vector<Label>& from) {
+    std::vector<Label>& row = labels[x];
+    std::size_t i = 0;                                 // 1er passage : rien à changer ?
+    bool changed = false;
+    for (const Label& l : from) {
+        while (i < row.size() && row[i].chain < l.chain) ++i;
+        if (i == row.size() || row[i].chain != l.chain || row[i].position > l.position) {
+            changed = true;
+            break;
+        }
+    }
+    if (!changed) return false;
+
+    scratch.clear();
+    std::size_t a = 0, b = 0;
+    while (a < row.size() && b < from.size()) {
+        if (row[a].chain < from[b].chain)      scratch.push_back(row[a++]);
+        else if (from[b].chain < row[a].chain) scratch.push_back(from[b++]);
+        else {
+            Label l = row[a++];
+            l.position = std::min(l.position, from[b++].position);
+            scratch.push_back(l);
+        }
+    }
+    scratch.insert(scratch.end(), row.begin() + a, row.end());
+    scratch.insert(scratch.end(), from.begin() + b, from.end());
+    labelCount += scratch.size() - row.size();
+    row.swap(scratch);
+    return true;
+}
+
+// cost : travail de recherche à atteindre avant de tenter une reconstruction
+void ReachabilityIndex::invalidate(std::size_t cost) {
+    fresh       = false;
+    rebuildCost = cost;
+    searchWork  = 0;
+    labelCount  = 0;
+    std::vector<std::vector<Label>>(kcOf.size()).swap(labels);
+    chainHead.clear();
+    chainTail.clear();
+}
+
+// chaînes gloutonnes dans l'ordre des rangs, listes en ordre inverse
+void ReachabilityIndex::relabel() {
+    const std::size_t n = kcOf.size();
+    std::vector<int> order(n);
+    for (std::size_t x = 0; x < n; ++x) order[x] = static_cast<int>(x);
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return rank[a] < rank[b]; });
+
+    chainHead.clear();
+    chainTail.clear();
+    for (int x : order) {                              // prolonge la chaîne d'un prédécesseur qui la termine
+        int after = -1;
+        for (int p : pred[x])
+            if (chainTail[chainOf[p]] == p) { after = p; break; }
+        if (after >= 0) extendChain(x, after);
+        else            openChain(x);
+    }
+
+    labelCount = 0;
+    for (std::size_t k = n; k-- > 0;) {               // successeurs déjà remplis
+        int x = order[k];
+        labels[x].assign(1, Label{chainOf[x], positionOf[x]});
+        ++labelCount;
+        for (int y : succ[x]) merge(x, labels[y]);
+        if (labelCount > MAX_LABELS) {                 // trop dense : recherche seulement
+            invalidate(n + edgeCount + MAX_LABELS);
+            return;
+        }
+    }
+    fresh      = true;
+    searchWork = 0;
+}
+
+/*======================================================================
+   MISES À JOUR
+======================================================================*/
+void ReachabilityIndex::rebuild(const std::vector<int>& nodes,
+                                const std::vector<std::pair<int,int>>& edges) {
+    clear();
+    slotOf.reserve(nodes.size());
+    for (int kc : nodes) isSource[node(kc)] = 1;
+    for (const auto& e : edges) {
+        int u = node(e.first), v = node(e.second);
+        succ[u].push_back(v);
+        pred[v].push_back(u);
+        isSource[u] = 1;
+    }
+    edgeCount = edges.size();
+
+    const int n = static_cast<int>(kcOf.size());     // rangs : ordre de Kahn
+    std::vector<int> indeg(n), order;
+    order.reserve(n);
+    for (int x = 0; x < n; ++x) {
+        indeg[x] = static_cast<int>(pred[x].size());
+        if (indeg[x] == 0) order.push_back(x);
+    }
+    for (std::size_t q = 0; q < order.size(); ++q)
+        for (int y : succ[order[q]])
+            if (--indeg[y] == 0) order.push_back(y);
+    for (int k = 0; k < static_cast<int>(order.size()); ++k) rank[order[k]] = k;
+    lowRank  = 0;
+    highRank = n - 1;
+    invalidate(n + edgeCount);                         // étiquettes à la demande
+}
+
+bool ReachabilityIndex::addEdge(int from, int to) {
+    if (from == to) return false;
+    auto a = slotOf.find(from), b = slotOf.find(to);
+    const bool newFrom = a == slotOf.end(), newTo = b == slotOf.end();
+    if (!newFrom && !newTo && !reorder(a->second, b->second)) return false;
+
+    // nouvelle KC : avant tous les rangs (source) ou après (destination)
+    int u = newFrom ? node(from) : a->second;
+    if (newFrom) rank[u] = --lowRank;
+    int v = newTo ? node(to) : b->second;
+    if (newTo) rank[v] = ++highRank;
+    succ[u].push_back(v);
+    pred[v].push_back(u);
+    isSource[u] = 1;
+    ++edgeCount;
+    if (fresh && !propagate(u, v, newFrom, newTo)) invalidate(kcOf.size() + edgeCount + labelCount);
+    return true;
+}
+
+// Listes à jour avant l'arête u → v (déjà insérée) : chaîne des nouveaux
+// nœuds, puis liste de v fusionnée chez les ancêtres de u. Une liste
+// inchangée arrête la remontée (ses ancêtres sont déjà au moins aussi bas).
+bool ReachabilityIndex::propagate(int u, int v, bool newFrom, bool newTo) {
+    if (newFrom) {
+        if (!newTo && chainHead[chainOf[v]] == v) prependChain(u, v);
+        else                                      openChain(u);
+        labels[u].assign(1, Label{chainOf[u], positionOf[u]});
+        ++labelCount;
+    }
+    if (newTo) {
+        if (chainTail[chainOf[u]] == u) extendChain(v, u);
+        else                            openChain(v);
+        labels[v].assign(1, Label{chainOf[v], positionOf[v]});
+        ++labelCount;
+    }
+
+    const std::size_t budget = labelCount / 2 + 4096;
+    std::size_t work = 0;
+    const std::vector<Label>& source = labels[v];
+    const int seen = nextRound();
+    std::vector<int> queue(1, u);
+    stamp[u] = seen;
+    for (std::size_t q = 0; q < queue.size(); ++q) {
+        int x = queue[q];
+        work += labels[x].size() + source.size();
+        if (work > budget || labelCount > MAX_LABELS) return false;
+        if (!merge(x, source)) continue;
+        for (int p : pred[x])
+            if (stamp[p] != seen) { stamp[p] = seen; queue.push_back(p); }
+    }
+    return true;
+}
+
+void ReachabilityIndex::removeEdge(int from, int to) {
+    auto a = slotOf.find(from), b = slotOf.find(to);
+    if (a == slotOf.end() || b == slotOf.end()) return;
+    const int u = a->second, v = b->second;
+    auto s = std::find(succ[u].begin(), succ[u].end(), v);
+    if (s == succ[u].end()) return;
+    succ[u].erase(s);
+    pred[v].erase(std::find(pred[v].begin(), pred[v].end(), u));
+    --edgeCount;
+    // l'ordre reste valide ; une chaîne peut être coupée
+    if (fresh) invalidate(kcOf.size() + edgeCount + labelCount);
+}
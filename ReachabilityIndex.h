@@ -0,0 +1,104 @@
+// ReachabilityIndex.h
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------
+//  « B est-il atteignable depuis A ? » sans parcourir tout le graphe, sur
+//  un DAG modifié arête par arête.
+//
+//  1. Ordre topologique dynamique (Pearce–Kelly) : un rang par KC, tel que
+//     u → v ⇒ rang(u) < rang(v). rang(A) > rang(B) suffit à répondre non.
+//     Une arête qui respecte déjà l'ordre coûte O(1) ; sinon seule la zone
+//     entre les deux rangs est parcourue, ce qui détecte aussi un cycle
+//     (addEdge refuse alors l'arête). Un retrait ne casse jamais l'ordre.
+//
+//  2. Étiquettes de chaînes, pour une réponse exacte en O(log n) : les KC
+//     sont couvertes par des chaînes (des chemins du graphe) et chaque KC
+//     garde, pour chaque chaîne qu'elle atteint, la plus petite position
+//     atteinte (liste triée par chaîne) ; A atteint B ⇔
+//         étiquette(A, chaîne(B)) <= position(B)
+//     Une arête ajoutée fusionne la liste de sa destination chez les
+//     ancêtres de sa source, tant que ce travail reste sous un budget
+//     (proportionnel à la taille des listes) ; au-delà, ou après un
+//     retrait, les listes sont périmées et reconstruites à la demande,
+//     dès que les recherches faites entre-temps ont coûté autant qu'une
+//     reconstruction. Une reconstruction qui dépasse MAX_LABELS entrées
+//     (réseau dense et large) est abandonnée : reste la recherche, un
+//     parcours en profondeur limité aux rangs compris entre A et B.
+//
+//  Threads : reaches() écrit dans les tampons de parcours et peut
+//  reconstruire les listes, il appartient au thread des modifications
+//  comme addEdge. excludes() ne fait que lire (rangs, listes à jour) :
+//  plusieurs threads peuvent l'appeler tant que l'index ne change pas.
+// ---------------------------------------------------------------------
+class ReachabilityIndex {
+public:
+    static const std::size_t MAX_LABELS = std::size_t(1) << 22;   // 32 Mo
+
+private:
+    struct Label {
+        int chain;
+        int position;        // plus petite position atteinte dans la chaîne
+    };
+
+    std::unordered_map<int, int>  slotOf;        // ID de KC → nœud dense
+    std::vector<int>              kcOf;
+    std::vector<std::vector<int>> succ, pred;
+    std::vector<char>             isSource;      // a eu une arête sortante
+    std::vector<int>              rank;          // ordre topologique
+    int                           lowRank = 0, highRank = -1;
+    std::size_t                   edgeCount = 0;
+
+    // parcours (recherche, zone de Pearce–Kelly, remontée des ancêtres)
+    std::vector<int>              stamp;
+    int                           round = 0;
+    std::vector<int>              stack;
+
+    // étiquettes : cache
+    bool                            fresh = true;
+    std::vector<int>                chainOf, positionOf;
+    std::vector<int>                chainHead, chainTail;   // chaîne → extrémités
+    std::vector<std::vector<Label>> labels;   // par nœud, triées par chaîne
+    std::size_t                     labelCount = 0;
+    std::size_t                     searchWork = 0;  // depuis la péremption
+    std::size_t                     rebuildCost = 0; // estimation
+    std::vector<Label>              scratch;
+
+    int  node(int kc_id);                        // nœud dense, créé au besoin
+    int  nextRound();
+    bool reorder(int u, int v);                  // arête u → v ; false : cycle
+    bool search(int from, int to);               // parcours limité par les rangs
+    bool labelled(int x, int y) const;           // listes à jour : x atteint y ?
+
+    void openChain(int x);
+    void extendChain(int x, int after);          // x suit after, fin de sa chaîne
+    void prependChain(int x, int before);        // x précède before, début de sa chaîne
+    bool merge(int x, const std::vector<Label>& from);   // true si la liste a changé
+    void invalidate(std::size_t cost);
+    void relabel();
+    bool propagate(int u, int v, bool newFrom, bool newTo);     // false : budget dépassé
+
+public:
+    void clear();
+
+    // nodes : KC présentes (même sans arête) ; edges : (from, to) sans cycle
+    void rebuild(const std::vector<int>& nodes, const std::vector<std::pair<int,int>>& edges);
+
+    // KC touchée par une arête, ou source d'une arête depuis retirée
+    // (mêmes KC que celles du graphe de GasNetwork)
+    bool contains(int kc_id) const;
+    bool reaches(int from, int to);              // from == to : vrai
+    // Absence de chemin prouvée sans parcours (rangs, listes à jour) ;
+    // false : chemin possible ou KC absente
+    bool excludes(int from, int to) const;
+
+    bool addEdge(int from, int to);              // false : cycle, rien n'est ajouté
+    void removeEdge(int from, int to);
+
+    std::size_t nodeCount() const   { return kcOf.size(); }
+    std::size_t labelTotal() const  { return labelCount; }
+    bool        isLabelled() const  { return fresh; }
+};
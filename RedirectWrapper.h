@@ -19,4 +19,12 @@ public:
     void redirect(std::ostream& dest) {
         stream.rdbuf(dest.rdbuf());
     }
-};
\ No newline at end of file
+};
+
+// Stream buffer that discards everything (used to silence std::cout
+// in headless tools: redirect_output_wrapper + null_output_buffer)
+class null_output_buffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
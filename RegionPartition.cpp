@@ -0,0 +1,454 @@
+#include "RegionPartition.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include "TaskScheduler.h"
+
+namespace {
+typedef RegionPartition::FlowType FlowType;
+
+const std::size_t TABLE_GRAIN = 4;            // entrées par tâche pour les tables
+
+// Deux mesures d'un chemin, même recherche à fixation de labels :
+// of() = valeur d'une arête, join() = ajout d'une arête au chemin
+struct Distance {
+    typedef float Value;
+    static Value origin()                    { return 0.0f; }
+    static Value none()                      { return std::numeric_limits<float>::infinity(); }
+    static bool  better(Value a, Value b)    { return a < b; }
+    static Value of(float w, FlowType)       { return w; }          // +inf : en réparation
+    static Value join(Value a, Value b)      { return a + b; }
+};
+
+struct Width {
+    typedef FlowType Value;
+    static Value origin()                    { return std::numeric_limits<FlowType>::max(); }
+    static Value none()                      { return 0; }
+    static bool  better(Value a, Value b)    { return a > b; }
+    static Value of(float, FlowType c)       { return c; }          // 0 : en réparation
+    static Value join(Value a, Value b)      { return std::min(a, b); }
+};
+
+template<typename Metric>
+struct Later {                                 // tas : la meilleure valeur au sommet
+    typedef std::pair<typename Metric::Value, int> Item;
+    bool operator()(const Item& a, const Item& b) const { return Metric::better(b.first, a.first); }
+};
+}
+
+/*======================================================================
+   CONSTRUCTION – régions, frontières, tables, recouvrement
+======================================================================*/
+RegionPartition::RegionPartition(std::shared_ptr<const GraphSnapshot> snapshot,
+                                 const std::unordered_map<int, int>& regionOfKc)
+    : snap(snapshot) {
+    const GraphSnapshot& g = *snap;
+    const int n = static_cast<int>(g.nodeCount());
+
+    // numéros de l'appelant → régions 0, 1, … dans l'ordre des numéros
+    std::vector<int> number(n);
+    std::map<int, int> index;
+    for (int i = 0; i < n; ++i) {
+        auto it = regionOfKc.find(g.kcId(i));
+        number[i] = it == regionOfKc.end() ? -1 : it->second;
+        index[number[i]] = 0;
+    }
+    regions.resize(index.size());
+    int next = 0;
+    for (auto& kv : index) { regions[next].id = kv.first; kv.second = next++; }
+
+    regionOf.resize(n);
+    localOf.resize(n);
+    for (int i = 0; i < n; ++i) {                      // indices croissants : nodes triés
+        Region& r = regions[index[number[i]]];
+        regionOf[i] = index[number[i]];
+        localOf[i]  = static_cast<int>(r.nodes.size());
+        r.nodes.push_back(i);
+    }
+
+    // frontières et graphe des régions
+    std::vector<char> entry(n, 0), exit(n, 0);
+    regionSucc.assign(regions.size(), std::vector<int>());
+    regionPred.assign(regions.size(), std::vector<int>());
+    for (int u = 0; u < n; ++u)
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); ++e) {
+            int v = g.target(e);
+            if (regionOf[u] == regionOf[v]) continue;
+            exit[u] = entry[v] = 1;
+            regionSucc[regionOf[u]].push_back(regionOf[v]);
+            regionPred[regionOf[v]].push_back(regionOf[u]);
+        }
+    for (std::size_t r = 0; r < regions.size(); ++r) {
+        for (std::vector<int>* links : { &regionSucc[r], &regionPred[r] }) {
+            std::sort(links->begin(), links->end());
+            links->erase(std::unique(links->begin(), links->end()), links->end());
+        }
+        Region& reg = regions[r];
+        for (int l = 0; l < static_cast<int>(reg.nodes.size()); ++l) {
+            if (entry[reg.nodes[l]]) reg.entries.push_back(l);
+            if (exit[reg.nodes[l]])  reg.exits.push_back(l);
+        }
+    }
+
+    TaskScheduler::shared().parallelFor(0, regions.size(), 1, [this](std::size_t first, std::size_t last) {
+        for (std::size_t r = first; r < last; ++r) buildRegion(regions[r]);
+    });
+    buildOverlay();
+}
+
+// CSR compact de la région, puis tables entrées × sorties
+void RegionPartition::buildRegion(Region& r) {
+    const GraphSnapshot& g = *snap;
+    const int m = static_cast<int>(r.nodes.size());
+    r.offsets.assign(m + 1, 0);
+    for (int i = 0; i < m; ++i) {
+        r.offsets[i] = static_cast<int>(r.targets.size());
+        int u = r.nodes[i];
+        for (int e = g.edgeBegin(u); e < g.edgeEnd(u); ++e) {
+            int v = g.target(e);
+            if (regionOf[v] != regionOf[u]) continue;
+            r.targets.push_back(localOf[v]);
+            r.weights.push_back(g.weight(e));
+            r.capacities.push_back(g.capacity(e));
+        }
+    }
+    r.offsets[m] = static_cast<int>(r.targets.size());
+
+    // arêtes entrantes : CSR inverse par comptage
+    r.inOffsets.assign(m + 1, 0);
+    for (int v : r.targets) ++r.inOffsets[v + 1];
+    for (int i = 0; i < m; ++i) r.inOffsets[i + 1] += r.inOffsets[i];
+    r.inEdges.resize(r.targets.size());
+    r.inSources.resize(r.targets.size());
+    std::vector<int> fill(r.inOffsets.begin(), r.inOffsets.end() - 1);
+    for (int u = 0; u < m; ++u)
+        for (int e = r.offsets[u]; e < r.offsets[u + 1]; ++e) {
+            int k = fill[r.targets[e]]++;
+            r.inEdges[k]   = e;
+            r.inSources[k] = u;
+        }
+
+    const std::size_t E = r.entries.size(), X = r.exits.size();
+    r.distance.assign(E * X, Distance::none());
+    r.capacity.assign(E * X, Width::none());
+    if (X == 0) return;
+    TaskScheduler::shared().parallelFor(0, E, TABLE_GRAIN, [&](std::size_t first, std::size_t last) {
+        std::vector<float>    dist;
+        std::vector<FlowType> width;
+        for (std::size_t k = first; k < last; ++k) {
+            searchRegion<Distance>(r, r.entries[k], false, -1, dist, nullptr);
+            searchRegion<Width>(r, r.entries[k], false, -1, width, nullptr);
+            for (std::size_t x = 0; x < X; ++x) {
+                r.distance[k * X + x] = dist[r.exits[x]];
+                r.capacity[k * X + x] = width[r.exits[x]];
+            }
+        }
+    });
+}
+
+void RegionPartition::buildOverlay() {
+    const GraphSnapshot& g = *snap;
+    const int n = static_cast<int>(g.nodeCount());
+    const int MARK = -2;                               // frontière, pas encore numérotée
+    overlayOf.assign(n, -1);
+    for (const Region& r : regions) {
+        for (int l : r.entries) overlayOf[r.nodes[l]] = MARK;
+        for (int l : r.exits)   overlayOf[r.nodes[l]] = MARK;
+    }
+    for (int i = 0; i < n; ++i)
+        if (overlayOf[i] == MARK) {
+            overlayOf[i] = static_cast<int>(overlayNodes.size());
+            overlayNodes.push_back(i);
+        }
+
+    overlayOffsets.assign(overlayNodes.size() + 1, 0);
+    for (std::size_t o = 0; o < overlayNodes.size(); ++o) {
+        overlayOffsets[o] = static_cast<int>(overlayTargets.size());
+        const int d = overlayNodes[o];
+        const Region& r = regions[regionOf[d]];
+        const int l = localOf[d];
+
+        // entrée : une arête par sortie atteinte dans la région
+        auto k = std::lower_bound(r.entries.begin(), r.entries.end(), l);
+        if (k != r.entries.end() && *k == l) {
+            const std::size_t row = (k - r.entries.begin()) * r.exits.size();
+            for (std::size_t x = 0; x < r.exits.size(); ++x) {
+                if (r.exits[x] == l) continue;
+                float    w = r.distance[row + x];
+                FlowType c = r.capacity[row + x];
+                if (std::isinf(w) && c == 0) continue;
+                overlayTargets.push_back(overlayOf[r.nodes[r.exits[x]]]);
+                overlayVia.push_back(-1);
+                overlayWeights.push_back(w);
+                overlayCapacities.push_back(c);
+            }
+        }
+        // sortie : ses arêtes vers les autres régions
+        for (int e = g.edgeBegin(d); e < g.edgeEnd(d); ++e) {
+            int v = g.target(e);
+            if (regionOf[v] == regionOf[d]) continue;
+            overlayTargets.push_back(overlayOf[v]);
+            overlayVia.push_back(e);
+            overlayWeights.push_back(g.weight(e));
+            overlayCapacities.push_back(g.capacity(e));
+        }
+    }
+    overlayOffsets[overlayNodes.size()] = static_cast<int>(overlayTargets.size());
+}
+
+int RegionPartition::regionIndexOf(int kc_id) const {
+    int i = snap->indexOf(kc_id);
+    return i < 0 ? -1 : regionOf[i];
+}
+
+void RegionPartition::forEachRegion(const std::function<void(const Region&)>& body) const {
+    TaskScheduler::shared().parallelFor(0, regions.size(), 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t r = first; r < last; ++r) body(regions[r]);
+    });
+}
+
+/*======================================================================
+   RECHERCHES – dans une région, puis recousues par le recouvrement
+======================================================================*/
+// Depuis start (indice local), en avant ou à rebours (valeur = chemin
+// jusqu'à start) ; link : prédécesseur (en avant) ou successeur (à rebours)
+template<typename Metric>
+void RegionPartition::searchRegion(const Region& r, int start, bool backward, int stop,
+                                   std::vector<typename Metric::Value>& value,
+                                   std::vector<int>* link) const {
+    typedef typename Later<Metric>::Item Item;
+    const Later<Metric> later;
+    value.assign(r.nodes.size(), Metric::none());
+    if (link) link->assign(r.nodes.size(), -1);
+    value[start] = Metric::origin();
+
+    std::vector<Item> heap(1, Item(Metric::origin(), start));
+    auto relax = [&](typename Metric::Value from, int u, int v, int e) {
+        typename Metric::Value nv = Metric::join(from, Metric::of(r.weights[e], r.capacities[e]));
+        if (!Metric::better(nv, value[v])) return;
+        value[v] = nv;
+        if (link) (*link)[v] = u;
+        heap.push_back(Item(nv, v));
+        std::push_heap(heap.begin(), heap.end(), later);
+    };
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        Item top = heap.back();
+        heap.pop_back();
+        int u = top.second;
+        if (top.first != value[u]) continue;          // entrée périmée
+        if (u == stop) break;
+        if (!backward)
+            for (int e = r.offsets[u]; e < r.offsets[u + 1]; ++e) relax(top.first, u, r.targets[e], e);
+        else
+            for (int k = r.inOffsets[u]; k < r.inOffsets[u + 1]; ++k) relax(top.first, u, r.inSources[k], r.inEdges[k]);
+    }
+}
+
+// s, t : indices denses. Meilleure valeur de s vers t ; path (si demandé) :
+// indices denses du chemin retenu
+template<typename Metric>
+typename Metric::Value RegionPartition::stitch(int s, int t, std::vector<int>* path) const {
+    typedef typename Metric::Value Value;
+    typedef typename Later<Metric>::Item Item;
+    const Region& from = regions[regionOf[s]];
+    const Region& to   = regions[regionOf[t]];
+
+    std::vector<Value> head, tail;                     // depuis s, jusqu'à t
+    std::vector<int>   headLink, tailLink;
+    searchRegion<Metric>(from, localOf[s], false, -1, head, path ? &headLink : nullptr);
+    searchRegion<Metric>(to, localOf[t], true, -1, tail, path ? &tailLink : nullptr);
+
+    Value best = regionOf[s] == regionOf[t] ? head[localOf[t]] : Metric::none();
+    int   bestNode = -1;                               // -1 : sans quitter la région
+
+    // recouvrement depuis les sorties de la région de s
+    const Later<Metric> later;
+    std::vector<Value> value(overlayNodes.size(), Metric::none());
+    std::vector<std::pair<int,int>> reached(overlayNodes.size(), std::make_pair(-1, -1));   // (nœud, arête)
+    std::vector<Item>  heap;
+    for (int x : from.exits) {
+        if (!Metric::better(head[x], Metric::none())) continue;
+        int o = overlayOf[from.nodes[x]];
+        value[o] = head[x];
+        heap.push_back(Item(head[x], o));
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        Item top = heap.back();
+        heap.pop_back();
+        int u = top.second;
+        if (top.first != value[u]) continue;
+        if (!Metric::better(top.first, best)) break;   // plus rien de meilleur
+        int d = overlayNodes[u];
+        if (regionOf[d] == regionOf[t]) {
+            Value c = Metric::join(top.first, tail[localOf[d]]);
+            if (Metric::better(c, best)) { best = c; bestNode = u; }
+        }
+        for (int e = overlayOffsets[u]; e < overlayOffsets[u + 1]; ++e) {
+            int v = overlayTargets[e];
+            Value nv = Metric::join(top.first, Metric::of(overlayWeights[e], overlayCapacities[e]));
+            if (!Metric::better(nv, value[v])) continue;
+            value[v] = nv;
+            reached[v] = std::make_pair(u, e);
+            heap.push_back(Item(nv, v));
+            std::push_heap(heap.begin(), heap.end(), later);
+        }
+    }
+    if (!path || !Metric::better(best, Metric::none())) return best;
+
+    // détail : région de s, tronçons du recouvrement, région de t
+    path->clear();
+    std::vector<int> hops;                             // nœuds du recouvrement, à l'envers
+    for (int o = bestNode; o >= 0; o = reached[o].first) hops.push_back(o);
+    const int last = hops.empty() ? localOf[t] : localOf[overlayNodes[hops.back()]];
+    std::vector<int> local;
+    for (int l = last; l >= 0; l = headLink[l]) local.push_back(from.nodes[l]);
+    std::reverse(local.begin(), local.end());
+    path->swap(local);
+
+    std::vector<Value> ignored;
+    std::vector<int>   link;
+    for (std::size_t h = hops.size(); h-- > 1; ) {
+        int u = hops[h], v = hops[h - 1];
+        if (overlayVia[reached[v].second] >= 0) { path->push_back(overlayNodes[v]); continue; }
+        const Region& r = regions[regionOf[overlayNodes[u]]];      // ligne de table : tronçon interne
+        int a = localOf[overlayNodes[u]], b = localOf[overlayNodes[v]];
+        searchRegion<Metric>(r, a, false, b, ignored, &link);
+        local.clear();
+        for (int l = b; l != a; l = link[l]) local.push_back(r.nodes[l]);
+        std::reverse(local.begin(), local.end());
+        path->insert(path->end(), local.begin(), local.end());
+    }
+    if (bestNode >= 0)
+        for (int l = tailLink[localOf[overlayNodes[bestNode]]]; l >= 0; l = tailLink[l])
+            path->push_back(to.nodes[l]);
+    return best;
+}
+
+std::vector<int> RegionPartition::findShortestPath(int source, int sink) const {
+    const int s = snap->indexOf(source), t = snap->indexOf(sink);
+    if (s < 0 || t < 0 || !snap->connected(s, t)) return {};
+    std::vector<int> nodes;
+    if (std::isinf(stitch<Distance>(s, t, &nodes))) return {};
+    for (int& i : nodes) i = snap->kcId(i);
+    return nodes;
+}
+
+float RegionPartition::distance(int source, int sink) const {
+    const int s = snap->indexOf(source), t = snap->indexOf(sink);
+    if (s < 0 || t < 0 || !snap->connected(s, t)) return Distance::none();
+    return stitch<Distance>(s, t, nullptr);
+}
+
+RegionPartition::FlowType RegionPartition::pathCapacity(int source, int sink) const {
+    const int s = snap->indexOf(source), t = snap->indexOf(sink);
+    if (s < 0 || t < 0 || !snap->connected(s, t)) return Width::none();
+    return stitch<Width>(s, t, nullptr);
+}
+
+/*======================================================================
+   DÉBIT MAXIMAL – Edmonds‑Karp sur les seules régions utiles
+======================================================================*/
+std::vector<int> RegionPartition::relevantRegions(int source, int sink) const {
+    const int a = regionIndexOf(source), b = regionIndexOf(sink);
+    if (a < 0 || b < 0) return {};
+
+    // atteintes depuis a, et qui atteignent b
+    auto sweep = [](const std::vector<std::vector<int>>& links, int start, std::vector<char>& seen) {
+        std::vector<int> stack(1, start);
+        seen[start] = 1;
+        while (!stack.empty()) {
+            int r = stack.back();
+            stack.pop_back();
+            for (int q : links[r]) if (!seen[q]) { seen[q] = 1; stack.push_back(q); }
+        }
+    };
+    std::vector<char> forward(regions.size(), 0), backward(regions.size(), 0);
+    sweep(regionSucc, a, forward);
+    sweep(regionPred, b, backward);
+    std::vector<int> keep;
+    for (std::size_t r = 0; r < regions.size(); ++r)
+        if (forward[r] && backward[r]) keep.push_back(static_cast<int>(r));
+    return keep;
+}
+
+long long RegionPartition::calculateMaxFlow(int source, int sink) const {
+    const int s = snap->indexOf(source), t = snap->indexOf(sink);
+    if (s < 0 || t < 0 || s == t || !snap->connected(s, t)) return 0;
+    const std::vector<int> keep = relevantRegions(source, sink);
+    if (keep.empty()) return 0;                        // région du puits inatteignable
+
+    // nœuds : régions retenues bout à bout
+    std::vector<int> base(regions.size(), -1);
+    int n = 0;
+    std::size_t internal = 0;
+    for (int r : keep) {
+        base[r] = n;
+        n += static_cast<int>(regions[r].nodes.size());
+        internal += regions[r].targets.size();
+    }
+    std::vector<int> tail, head;                       // arête k : tail[k] → head[k]
+    std::vector<long long> capacity;
+    tail.reserve(internal);
+    head.reserve(internal);
+    capacity.reserve(internal);
+    for (int r : keep) {
+        const Region& reg = regions[r];
+        for (int u = 0; u < static_cast<int>(reg.nodes.size()); ++u)
+            for (int e = reg.offsets[u]; e < reg.offsets[u + 1]; ++e) {
+                tail.push_back(base[r] + u);
+                head.push_back(base[r] + reg.targets[e]);
+                capacity.push_back(reg.capacities[e]);
+            }
+        for (int x : reg.exits) {
+            int d = reg.nodes[x];
+            for (int e = snap->edgeBegin(d); e < snap->edgeEnd(d); ++e) {
+                int v = snap->target(e), q = regionOf[v];
+                if (q == r || base[q] < 0) continue;
+                tail.push_back(base[r] + x);
+                head.push_back(base[q] + localOf[v]);
+                capacity.push_back(snap->capacity(e));
+            }
+        }
+    }
+
+    // arcs résiduels (2k, 2k+1), comme MaxFlowTask
+    const int m = static_cast<int>(tail.size());
+    std::vector<int> start(n + 1, 0), arcs(2 * m), to(2 * m);
+    std::vector<long long> residual(2 * m);
+    for (int k = 0; k < m; ++k) { ++start[tail[k] + 1]; ++start[head[k] + 1]; }
+    for (int u = 0; u < n; ++u) start[u + 1] += start[u];
+    std::vector<int> fill(start.begin(), start.end() - 1);
+    for (int k = 0; k < m; ++k) {
+        to[2 * k]     = head[k]; residual[2 * k]     = capacity[k]; arcs[fill[tail[k]]++] = 2 * k;
+        to[2 * k + 1] = tail[k]; residual[2 * k + 1] = 0;           arcs[fill[head[k]]++] = 2 * k + 1;
+    }
+
+    const int ls = base[regionOf[s]] + localOf[s], lt = base[regionOf[t]] + localOf[t];
+    std::vector<int> via(n), fifo(n);
+    long long total = 0;
+    while (true) {
+        std::fill(via.begin(), via.end(), -1);
+        via[ls] = -2;
+        fifo[0] = ls;
+        for (int q = 0, end = 1; q < end && via[lt] == -1; ++q) {
+            int u = fifo[q];
+            for (int k = start[u]; k < start[u + 1]; ++k) {
+                int a = arcs[k], v = to[a];
+                if (via[v] == -1 && residual[a] > 0) { via[v] = a; fifo[end++] = v; }
+            }
+        }
+        if (via[lt] == -1) break;
+        long long pathFlow = std::numeric_limits<long long>::max();
+        for (int v = lt; v != ls; v = to[via[v] ^ 1]) pathFlow = std::min(pathFlow, residual[via[v]]);
+        for (int v = lt; v != ls; v = to[via[v] ^ 1]) {
+            residual[via[v]]     -= pathFlow;
+            residual[via[v] ^ 1] += pathFlow;
+        }
+        total += pathFlow;
+    }
+    return total;
+}
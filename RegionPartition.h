@@ -0,0 +1,106 @@
+// RegionPartition.h
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "GraphSnapshot.h"
+
+// ---------------------------------------------------------------------
+//  Réseau découpé en régions (réseaux régionaux reliés par quelques KC
+//  d'interconnexion), sur une version figée du graphe.
+//
+//  Chaque région garde son propre CSR compact : ses KC, ses arêtes
+//  internes (sortantes et entrantes), leurs poids et capacités. Les
+//  arêtes entre régions relient des KC frontières : entrées (arête
+//  entrante d'une autre région) et sorties (arête sortante vers une autre
+//  région). Pour chaque région, les tables entrées × sorties donnent la
+//  plus courte distance et la capacité du chemin le plus large (goulot)
+//  à l'intérieur de la région ; elles sont calculées région par région
+//  en parallèle sur le TaskScheduler partagé.
+//
+//  Requêtes recousues : les tables et les arêtes entre régions forment
+//  un petit graphe de recouvrement (les KC frontières). Un chemin de A
+//  vers B = recherche locale depuis A dans sa région, recherche dans le
+//  recouvrement, recherche locale à rebours depuis B dans sa région ;
+//  seules les régions traversées par le chemin retenu sont relues pour
+//  le détailler. Le débit maximal ne se découpe pas exactement (les
+//  chemins d'une région se partagent ses tuyaux) : il est calculé sur les
+//  seules régions qui peuvent se trouver sur un chemin de A vers B.
+//
+//  Immuable une fois construit : lisible depuis n'importe quel thread,
+//  comme la GraphSnapshot qu'il garde. Mêmes conventions qu'elle (KC
+//  absente → résultat vide / 0, tuyau en réparation ignoré).
+// ---------------------------------------------------------------------
+class RegionPartition {
+public:
+    typedef GraphSnapshot::FlowType FlowType;
+
+    struct Region {
+        int                   id = -1;       // numéro donné par l'appelant (-1 : KC sans région)
+        std::vector<int>      nodes;         // local → indice dense de la version (croissants)
+        std::vector<int>      offsets;       // arêtes internes de i : [offsets[i], offsets[i+1])
+        std::vector<int>      targets;       // indice local de la destination
+        std::vector<float>    weights;
+        std::vector<FlowType> capacities;
+        std::vector<int>      inOffsets;     // arêtes internes entrantes de i
+        std::vector<int>      inEdges;       // indice de l'arête interne
+        std::vector<int>      inSources;     // indice local de son origine
+        std::vector<int>      entries;       // indices locaux, croissants
+        std::vector<int>      exits;
+        std::vector<float>    distance;      // entries.size() × exits.size() (+inf : aucun chemin)
+        std::vector<FlowType> capacity;      // même forme (0 : aucun chemin)
+    };
+
+private:
+    std::shared_ptr<const GraphSnapshot> snap;
+    std::vector<Region>                  regions;
+    std::vector<int>                     regionOf;        // indice dense → région
+    std::vector<int>                     localOf;         // indice dense → indice local
+    std::vector<std::vector<int>>        regionSucc, regionPred;   // arêtes entre régions
+
+    // recouvrement : un nœud par KC frontière ; arête = ligne de table
+    // (via -1) ou arête entre régions (via = arête de la version)
+    std::vector<int>      overlayOf;                      // indice dense → nœud (-1 : intérieur)
+    std::vector<int>      overlayNodes;                   // nœud → indice dense
+    std::vector<int>      overlayOffsets, overlayTargets, overlayVia;
+    std::vector<float>    overlayWeights;
+    std::vector<FlowType> overlayCapacities;
+
+    void buildRegion(Region& r);
+    void buildOverlay();
+
+    template<typename Metric>
+    void searchRegion(const Region& r, int start, bool backward, int stop,
+                      std::vector<typename Metric::Value>& value, std::vector<int>* link) const;
+    template<typename Metric>
+    typename Metric::Value stitch(int s, int t, std::vector<int>* path) const;
+
+public:
+    // regionOf : ID de KC → numéro de région ; les KC absentes de la carte
+    // forment ensemble une région de numéro -1
+    RegionPartition(std::shared_ptr<const GraphSnapshot> snapshot,
+                    const std::unordered_map<int, int>& regionOfKc);
+
+    const std::shared_ptr<const GraphSnapshot>& snapshot() const { return snap; }
+    std::uint64_t version() const { return snap->version(); }
+
+    std::size_t   regionCount() const                 { return regions.size(); }
+    const Region& region(std::size_t r) const          { return regions[r]; }
+    int           regionIndexOf(int kc_id) const;      // -1 si KC absente
+    std::size_t   boundaryCount() const                { return overlayNodes.size(); }
+
+    // body(région) pour chaque région, en parallèle sur le TaskScheduler
+    // partagé ; retour quand toutes sont traitées
+    void forEachRegion(const std::function<void(const Region&)>& body) const;
+
+    // Mêmes résultats que GraphSnapshot (chemin en IDs de KC, vide si aucun)
+    std::vector<int> findShortestPath(int source, int sink) const;
+    float            distance(int source, int sink) const;       // +inf si aucun chemin
+    FlowType         pathCapacity(int source, int sink) const;   // goulot du chemin le plus large
+    long long        calculateMaxFlow(int source, int sink) const;
+
+    // régions que peut traverser un chemin de source vers sink (vide si aucune)
+    std::vector<int> relevantRegions(int source, int sink) const;
+};
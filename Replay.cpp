@@ -0,0 +1,486 @@
+// Replay.cpp – rejoue user_actions.log (texte ou binaire) sans interface
+// contre Pipe / KC / GasNetwork et mesure chaque type d'opération.
+//
+//   g++ -std=c++11 -O2 -o replay Replay.cpp Pipe.cpp KC.cpp GasNetwork.cpp ReachabilityIndex.cpp ComponentIndex.cpp RegionPartition.cpp
+//       Logger.cpp EventLog.cpp DataFile.cpp PipeStore.cpp CompanyIndex.cpp TrigramIndex.cpp StringPool.cpp IdAllocator.cpp ScenarioOverlay.cpp GraphSnapshot.cpp AnalysisTask.cpp TaskScheduler.cpp -pthread
+//   replay [user_actions.log | user_actions.bin] [--repeat N] [--json]
+//
+// Le journal texte ne contient pas les IDs des tuyaux / KC modifiés : on
+// les retrouve par nom, comme le ferait l'opérateur via « Search by name ».
+// Le journal binaire (--binary-log) conserve les IDs et se rejoue à l'identique.
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include "Pipe.h"
+#include "KC.h"
+#include "GasNetwork.h"
+#include "IdAllocator.h"
+#include "DataFile.h"
+#include "Logger.h"
+#include "EventLog.h"
+#include "LatencyStats.h"
+#include "RedirectWrapper.h"
+
+namespace {
+
+enum class OpType {
+    AddPipe, EditPipe, DeletePipe,
+    AddCompany, EditCompany, DeleteCompany,
+    AddConnection, Save, Load,
+    Count
+};
+
+const char* opName(OpType t) {
+    switch (t) {
+        case OpType::AddPipe:       return "add_pipe";
+        case OpType::EditPipe:      return "edit_pipe";
+        case OpType::DeletePipe:    return "delete_pipe";
+        case OpType::AddCompany:    return "add_company";
+        case OpType::EditCompany:   return "edit_company";
+        case OpType::DeleteCompany: return "delete_company";
+        case OpType::AddConnection: return "add_connection";
+        case OpType::Save:          return "save";
+        case OpType::Load:          return "load";
+        default:                    return "?";
+    }
+}
+
+struct Operation {
+    OpType      type;
+    int         id = 0;                 // 0 = inconnu (journal texte) → recherche par nom
+    std::string name;
+    float       length = 0.0f;
+    int         diameter = 0;
+    bool        repair = false;
+    int         workshops = 0;
+    int         workshopsInOperation = 0;
+    std::string classes;
+    int         from = 0, to = 0, pipe = 0;
+    int         snapshot = -1;          // Load : index du fichier préparé
+};
+
+struct Snapshot {
+    std::vector<Pipe> pipes;
+    std::vector<KC>   companies;
+};
+
+struct Workload {
+    std::vector<Operation> ops;
+    std::vector<Snapshot>  snapshots;   // contenus lus via LOAD PIPE / LOAD COMPANY
+    std::size_t            ignored = 0; // lignes non rejouables
+};
+
+/*======================================================================
+   PARSING – format texte
+======================================================================*/
+// "action12 for the pipes" → "for the pipes"
+// (les anciens journaux contiennent aussi "action3for the pipe" et "action: 5 for the companies")
+bool actionHeader(const std::string& line, std::string& suffix) {
+    if (line.compare(0, 6, "action") != 0) return false;
+    std::size_t i = 6;
+    while (i < line.size() && (line[i] == ':' || line[i] == ' ')) ++i;
+    std::size_t digits = i;
+    while (i < line.size() && line[i] >= '0' && line[i] <= '9') ++i;
+    if (i == digits) return false;
+    while (i < line.size() && line[i] == ' ') ++i;
+    suffix = line.substr(i);
+    return true;
+}
+
+bool parseFloat(const std::string& s, float& out) {
+    char* end = nullptr;
+    out = std::strtof(s.c_str(), &end);
+    return end != s.c_str() && *end == '\0';
+}
+
+bool parseInt(const std::string& s, int& out) {
+    char* end = nullptr;
+    double v = std::strtod(s.c_str(), &end);     // le diamètre est écrit comme un double
+    out = static_cast<int>(v);
+    return end != s.c_str() && *end == '\0';
+}
+
+// "[2025-12-09 22:32:49] Added pipe" → "Added pipe" (lignes anciennes sans horodatage)
+std::string stripTimestamp(const std::string& line) {
+    if (!line.empty() && line[0] == '[') {
+        std::size_t close = line.find("] ");
+        if (close != std::string::npos) return line.substr(close + 2);
+    }
+    return line;
+}
+
+class WorkloadBuilder {
+private:
+    Workload  w;
+    Snapshot  pending;                 // LOAD PIPE / LOAD COMPANY avant « Loaded data »
+    int       lastSaveIndex = -1;
+
+public:
+    void pipeEvent(const std::string& label, int id, const std::string& name,
+                   float length, int diameter, bool repair) {
+        if (label == "LOAD PIPE") {
+            int pid = id > 0 ? id : static_cast<int>(pending.pipes.size()) + 1;
+            pending.pipes.push_back(Pipe(pid, name, length, diameter, repair));
+            return;
+        }
+        Operation op;
+        if (label.empty())               op.type = OpType::AddPipe;
+        else if (label == "EDIT PIPE")   op.type = OpType::EditPipe;
+        else if (label == "DELETE PIPE") op.type = OpType::DeletePipe;
+        else { ++w.ignored; return; }
+        op.id = id; op.name = name; op.length = length;
+        op.diameter = diameter; op.repair = repair;
+        w.ops.push_back(op);
+    }
+
+    void companyEvent(const std::string& label, int id, const std::string& name,
+                      int workshops, int inOperation, const std::string& classes) {
+        if (label == "LOAD COMPANY") {
+            int cid = id > 0 ? id : static_cast<int>(pending.companies.size()) + 1;
+            pending.companies.push_back(KC(cid, name, workshops, inOperation, classes));
+            return;
+        }
+        Operation op;
+        if (label.empty())                  op.type = OpType::AddCompany;
+        else if (label == "EDIT COMPANY")   op.type = OpType::EditCompany;
+        else if (label == "DELETE COMPANY") op.type = OpType::DeleteCompany;
+        else { ++w.ignored; return; }
+        op.id = id; op.name = name; op.workshops = workshops;
+        op.workshopsInOperation = inOperation; op.classes = classes;
+        w.ops.push_back(op);
+    }
+
+    void textEvent(const std::string& text) {
+        Operation op;
+        char tail = 0;
+        if (std::sscanf(text.c_str(), "Added connection: KC%d -> KC%d using pipe %d%c",
+                        &op.from, &op.to, &op.pipe, &tail) == 3) {
+            op.type = OpType::AddConnection;
+        } else if (text.compare(0, 20, "Saved data to file: ") == 0) {
+            op.type = OpType::Save;
+            lastSaveIndex = static_cast<int>(w.ops.size());
+        } else if (text.compare(0, 23, "Loaded data from file: ") == 0) {
+            op.type = OpType::Load;
+            if (!pending.pipes.empty() || !pending.companies.empty()) {
+                op.snapshot = static_cast<int>(w.snapshots.size());
+                w.snapshots.push_back(pending);
+                pending = Snapshot();
+            } else if (lastSaveIndex < 0) {
+                ++w.ignored;            // contenu inconnu et rien sauvegardé avant
+                return;
+            }
+        } else if (std::sscanf(text.c_str(), "Deleted pipe %d%c", &op.id, &tail) == 1) {
+            op.type = OpType::DeletePipe;
+        } else if (std::sscanf(text.c_str(), "Deleted company %d%c", &op.id, &tail) == 1) {
+            op.type = OpType::DeleteCompany;
+        } else {
+            ++w.ignored;                // « Added pipe », « Exited program », erreurs…
+            return;
+        }
+        w.ops.push_back(op);
+    }
+
+    void skip() { ++w.ignored; }
+    Workload take() { return std::move(w); }
+};
+
+bool isCompanyLabel(const std::string& s) {
+    return s == "EDIT COMPANY" || s == "DELETE COMPANY" || s == "LOAD COMPANY";
+}
+
+Workload parseTextLog(std::istream& in) {
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        lines.push_back(line);
+    }
+
+    WorkloadBuilder b;
+    std::size_t i = 0, n = lines.size();
+    while (i < n) {
+        std::string suffix;
+        if (actionHeader(lines[i], suffix)) {
+            float length; int a, c;
+            if ((suffix == "for the pipes" || suffix == "for the pipe") && i + 4 < n &&
+                parseFloat(lines[i + 2], length) && parseInt(lines[i + 3], a)) {
+                bool labelled = suffix == "for the pipe" && i + 5 < n;
+                b.pipeEvent(labelled ? lines[i + 5] : std::string(), 0, lines[i + 1],
+                            length, a, lines[i + 4] == "yes");
+                i += labelled ? 6 : 5;
+                continue;
+            }
+            if (suffix == "for the companies" && i + 4 < n &&
+                parseInt(lines[i + 2], a) && parseInt(lines[i + 3], c)) {
+                bool labelled = i + 5 < n && isCompanyLabel(lines[i + 5]);
+                b.companyEvent(labelled ? lines[i + 5] : std::string(), 0, lines[i + 1],
+                               a, c, lines[i + 4]);
+                i += labelled ? 6 : 5;
+                continue;
+            }
+            b.skip(); ++i;
+            continue;
+        }
+        if (!lines[i].empty()) b.textEvent(stripTimestamp(lines[i]));
+        ++i;
+    }
+    return b.take();
+}
+
+/*======================================================================
+   PARSING – format binaire
+======================================================================*/
+Workload parseBinaryLog(BinaryEventReader& in) {
+    WorkloadBuilder b;
+    EventRecord rec;
+    while (in.next(rec)) {
+        switch (static_cast<EventType>(rec.type)) {
+            case EventType::Text:
+                b.textEvent(in.str(rec.label));
+                break;
+            case EventType::PipeSimple:
+            case EventType::PipeAction:
+                b.pipeEvent(in.str(rec.label), rec.id, in.str(rec.name),
+                            static_cast<float>(rec.length), rec.a,
+                            (rec.flags & EVENT_FLAG_REPAIR) != 0);
+                break;
+            case EventType::CompanySimple:
+            case EventType::CompanyAction:
+                b.companyEvent(in.str(rec.label), rec.id, in.str(rec.name),
+                               rec.a, rec.b, in.str(rec.classes));
+                break;
+            default:
+                break;
+        }
+    }
+    return b.take();
+}
+
+/*======================================================================
+   EXÉCUTION
+======================================================================*/
+class Replayer {
+private:
+    std::unordered_map<int, Pipe> pipes;
+    std::unordered_map<int, KC>   companies;
+    GasNetwork                    network;
+    IdAllocator                   pipeIds;
+    IdAllocator                   companyIds;
+    const std::vector<std::string>& snapshotFiles;
+    std::string                     saveFile;
+
+    int findPipe(const Operation& op) const {
+        if (op.id > 0) return pipes.count(op.id) ? op.id : 0;
+        int fallback = 0;
+        for (const auto& kv : pipes)
+            if (kv.second.getName() == op.name) {
+                if (kv.second.isRepair() != op.repair) return kv.first;   // celui qui a changé
+                if (!fallback) fallback = kv.first;
+            }
+        return fallback;
+    }
+
+    int findCompany(const Operation& op) const {
+        if (op.id > 0) return companies.count(op.id) ? op.id : 0;
+        for (const auto& kv : companies)
+            if (kv.second.getName() == op.name) return kv.first;
+        return 0;
+    }
+
+public:
+    Replayer(const std::vector<std::string>& files, const std::string& save)
+        : network(pipes), snapshotFiles(files), saveFile(save) {}
+
+    bool run(const Operation& op) {
+        switch (op.type) {
+            case OpType::AddPipe: {
+                int id = addPipe(pipes, pipeIds, op.name, op.length, op.diameter, op.repair);
+                network.updatePipeInNetwork(id);
+                return true;
+            }
+            case OpType::EditPipe: {
+                int id = findPipe(op);
+                if (!id) return false;
+                pipes[id].setRepair(op.repair);
+                network.updatePipeInNetwork(id);
+                return true;
+            }
+            case OpType::DeletePipe: {
+                int id = findPipe(op);
+                if (!id) return false;
+                if (network.isPipeInNetwork(id)) network.removeConnectionByPipe(id);
+                pipes.erase(id);
+                pipeIds.release(id);
+                network.updatePipeInNetwork(id);
+                return true;
+            }
+            case OpType::AddCompany:
+                addCompany(companies, companyIds, op.name, op.workshops,
+                           op.workshopsInOperation, op.classes);
+                return true;
+            case OpType::EditCompany: {
+                int id = findCompany(op);
+                if (!id) return false;
+                companies[id] = KC(id, companies[id].getName(), op.workshops,
+                                   op.workshopsInOperation, op.classes);
+                return true;
+            }
+            case OpType::DeleteCompany: {
+                int id = findCompany(op);
+                if (!id || !network.canDeleteKC(id)) return false;
+                companies.erase(id);
+                companyIds.release(id);
+                return true;
+            }
+            case OpType::AddConnection: {
+                if (op.from == op.to || !companies.count(op.from) || !companies.count(op.to))
+                    return false;
+                if (network.connectionExists(op.from, op.to) || network.isPipeUsed(op.pipe))
+                    return false;
+                return network.addConnection(op.from, op.to, op.pipe);
+            }
+            case OpType::Save:
+                saveToFile(pipes, companies, saveFile);
+                return true;
+            case OpType::Load: {
+                std::string file = op.snapshot >= 0 ? snapshotFiles[op.snapshot] : saveFile;
+                bool loaded = loadFromFile(pipes, companies, file);
+                pipeIds.assign(pipes);                  // tables remplacées (même en cas d'échec partiel)
+                companyIds.assign(companies);
+                network.refreshPipes();
+                return loaded;
+            }
+            default:
+                return false;
+        }
+    }
+};
+
+bool writeSnapshot(const Snapshot& s, const std::string& file) {
+    std::ofstream out(file);
+    out << s.pipes.size() << '\n';
+    for (const Pipe& p : s.pipes) out << p << '\n';
+    out << s.companies.size() << '\n';
+    for (const KC& c : s.companies) out << c << '\n';
+    return static_cast<bool>(out);
+}
+
+void printReport(std::vector<LatencyStats>& stats, const std::vector<std::size_t>& failed,
+                 bool json, const std::string& source, int passes) {
+    if (!json) {
+        std::printf("%-16s %9s %7s %12s %10s %10s %10s %10s\n",
+                    "operation", "count", "failed", "ops/s", "p50(us)", "p90(us)", "p99(us)", "max(us)");
+    }
+    for (std::size_t t = 0; t < stats.size(); ++t) {
+        LatencyStats& s = stats[t];
+        if (s.count() == 0) continue;
+        const char* name = opName(static_cast<OpType>(t));
+        if (json) {
+            std::printf("{\"source\":\"%s\",\"passes\":%d,\"op\":\"%s\",\"count\":%zu,"
+                        "\"failed\":%zu,\"ops_per_s\":%.1f,\"p50_ns\":%lld,"
+                        "\"p90_ns\":%lld,\"p99_ns\":%lld,\"max_ns\":%lld}\n",
+                        source.c_str(), passes, name, s.count(), failed[t], s.throughput(),
+                        s.percentile(50), s.percentile(90), s.percentile(99), s.max());
+        } else {
+            std::printf("%-16s %9zu %7zu %12.0f %10.2f %10.2f %10.2f %10.2f\n",
+                        name, s.count(), failed[t], s.throughput(),
+                        s.percentile(50) / 1e3, s.percentile(90) / 1e3,
+                        s.percentile(99) / 1e3, s.max() / 1e3);
+        }
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string logFile = "user_actions.log";
+    int  repeat = 1;
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc) repeat = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--json") json = true;
+        else if (arg[0] != '-') logFile = arg;
+        else {
+            std::cerr << "Usage: replay [log] [--repeat N] [--json]\n";
+            return 2;
+        }
+    }
+
+    Workload w;
+    {
+        BinaryEventReader bin(logFile);
+        if (bin.isValid()) {
+            w = parseBinaryLog(bin);
+            if (bin.isCorrupt()) {
+                std::cerr << "Corrupt binary event log: " << logFile << '\n';
+                return 1;
+            }
+        } else {
+            std::ifstream in(logFile);
+            if (!in.is_open()) {
+                std::cerr << "Unable to open " << logFile << '\n';
+                return 1;
+            }
+            w = parseTextLog(in);
+        }
+    }
+
+    // fichiers de travail : un par chargement + un pour les sauvegardes
+    std::vector<std::string> snapshotFiles;
+    for (std::size_t i = 0; i < w.snapshots.size(); ++i) {
+        snapshotFiles.push_back("replay_load_" + std::to_string(i) + ".tmp");
+        if (!writeSnapshot(w.snapshots[i], snapshotFiles.back())) {
+            std::cerr << "Unable to write " << snapshotFiles.back() << '\n';
+            return 1;
+        }
+    }
+    const std::string saveFile = "replay_save.tmp";
+
+    std::vector<LatencyStats> stats(static_cast<std::size_t>(OpType::Count));
+    std::vector<std::size_t>  failed(stats.size(), 0);
+    LatencyStats::Clock::time_point begin, end;
+    {
+        // ni journal ni affichage pendant le rejeu : on mesure le modèle
+        Logger::setMuted(true);
+        null_output_buffer nullBuf;
+        std::ostream       nullOut(&nullBuf);
+        redirect_output_wrapper quietOut(std::cout), quietErr(std::cerr);
+        quietOut.redirect(nullOut);
+        quietErr.redirect(nullOut);
+
+        begin = LatencyStats::Clock::now();
+        for (int pass = 0; pass < repeat; ++pass) {
+            Replayer r(snapshotFiles, saveFile);
+            for (const Operation& op : w.ops) {
+                auto t0 = LatencyStats::Clock::now();
+                bool ok = r.run(op);
+                auto t1 = LatencyStats::Clock::now();
+                std::size_t t = static_cast<std::size_t>(op.type);
+                stats[t].add(t0, t1);
+                if (!ok) ++failed[t];
+            }
+        }
+        end = LatencyStats::Clock::now();
+        Logger::setMuted(false);
+    }
+
+    for (const std::string& f : snapshotFiles) std::remove(f.c_str());
+    std::remove(saveFile.c_str());
+
+    double seconds = std::chrono::duration<double>(end - begin).count();
+    std::size_t total = w.ops.size() * static_cast<std::size_t>(repeat);
+    if (!json) {
+        std::printf("Replayed %zu operations (%d pass%s) from %s in %.3f ms, %.0f ops/s; "
+                    "%zu log entries not replayable\n",
+                    total, repeat, repeat > 1 ? "es" : "", logFile.c_str(),
+                    seconds * 1e3, seconds > 0 ? total / seconds : 0.0, w.ignored);
+    }
+    printReport(stats, failed, json, logFile, repeat);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "ScenarioOverlay.h"
+
+void ScenarioOverlay::setPipeState(int pipe_id, FlowType capacity, float weight) {
+    PipeState s;
+    s.capacity = capacity;
+    s.weight   = weight;
+    pipeStates[pipe_id] = s;
+    for (auto& kv : addedEdges)                      // arête ajoutée avec ce tuyau
+        for (GasNetwork::Edge& e : kv.second)
+            if (e.pipe_id == pipe_id) { e.capacity = capacity; e.weight = weight; }
+}
+
+void ScenarioOverlay::setRepair(const Pipe& pipe, bool repair) {
+    Pipe changed(pipe);
+    changed.setRepair(repair);
+    setPipeState(pipe.getId(), static_cast<FlowType>(changed.getCapacity()), changed.getWeight());
+}
+
+// retire l'arête réelle du tuyau, et celle que le scénario aurait ajoutée
+void ScenarioOverlay::removeConnection(int pipe_id) {
+    removedPipes.insert(pipe_id);
+    for (auto it = addedEdges.begin(); it != addedEdges.end();) {
+        std::vector<GasNetwork::Edge>& edges = it->second;
+        for (std::size_t i = 0; i < edges.size();)
+            if (edges[i].pipe_id == pipe_id) edges.erase(edges.begin() + i);
+            else ++i;
+        if (edges.empty()) it = addedEdges.erase(it);
+        else ++it;
+    }
+}
+
+void ScenarioOverlay::addConnection(int from, int to, const Pipe& pipe) {
+    GasNetwork::Edge e;
+    e.to       = to;
+    e.pipe_id  = pipe.getId();
+    e.flow     = 0;
+    const PipeState* s = stateOf(pipe.getId());
+    e.capacity = s ? s->capacity : static_cast<FlowType>(pipe.getCapacity());
+    e.weight   = s ? s->weight   : pipe.getWeight();
+    addedEdges[from].push_back(e);
+}
+
+void ScenarioOverlay::clear() {
+    pipeStates.clear();
+    removedPipes.clear();
+    addedEdges.clear();
+}
+
+std::size_t ScenarioOverlay::changeCount() const {
+    std::size_t n = pipeStates.size() + removedPipes.size();
+    for (const auto& kv : addedEdges) n += kv.second.size();
+    return n;
+}
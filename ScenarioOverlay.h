@@ -0,0 +1,55 @@
+// ScenarioOverlay.h
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "GasNetwork.h"
+
+// ---------------------------------------------------------------------
+//  Scénario « et si… » posé sur un GasNetwork sans le modifier.
+//
+//  Le scénario ne contient que les écarts avec le réseau réel : état
+//  (capacité / poids) de quelques tuyaux, arêtes retirées (par tuyau) et
+//  arêtes ajoutées. Les analyses de GasNetwork (findShortestPath,
+//  calculateMaxFlow, topologicalSort) le lisent à la volée.
+//
+//  Les analyses sont const et un scénario n'est lu que par elles : autant
+//  de scénarios que l'on veut peuvent être évalués en parallèle sur le
+//  même réseau, tant que celui-ci n'est pas modifié pendant ce temps.
+// ---------------------------------------------------------------------
+class ScenarioOverlay {
+public:
+    typedef GasNetwork::Edge::FlowType FlowType;
+
+    struct PipeState {
+        FlowType capacity;
+        float    weight;
+    };
+
+private:
+    std::unordered_map<int, PipeState>                     pipeStates;    // tuyau → état remplacé
+    std::unordered_set<int>                                removedPipes;  // arêtes retirées
+    std::unordered_map<int, std::vector<GasNetwork::Edge>> addedEdges;    // KC source → arêtes
+
+public:
+    // ----- construction du scénario ---------------------------------------
+    void setPipeState(int pipe_id, FlowType capacity, float weight);
+    void setRepair(const Pipe& pipe, bool repair);         // état calculé comme Pipe
+    void removeConnection(int pipe_id);                    // arête du réseau réel
+    void addConnection(int from, int to, const Pipe& pipe);
+    void clear();
+
+    // ----- lecture (analyses) ---------------------------------------------
+    const PipeState* stateOf(int pipe_id) const {
+        auto it = pipeStates.find(pipe_id);
+        return it == pipeStates.end() ? nullptr : &it->second;
+    }
+    bool isRemoved(int pipe_id) const { return removedPipes.count(pipe_id) != 0; }
+    const std::unordered_map<int, std::vector<GasNetwork::Edge>>& added() const { return addedEdges; }
+
+    bool empty() const { return pipeStates.empty() && removedPipes.empty() && addedEdges.empty(); }
+    // mêmes arêtes que le réseau réel (seuls des états de tuyaux changent)
+    bool keepsTopology() const { return removedPipes.empty() && addedEdges.empty(); }
+    std::size_t changeCount() const;
+};
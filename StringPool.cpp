@@ -0,0 +1,126 @@
+#include "StringPool.h"
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const std::size_t CHUNK_BITS = 12;                       // 4096 chaînes par bloc
+const std::size_t CHUNK_SIZE = std::size_t(1) << CHUNK_BITS;
+const std::size_t MAX_CHUNKS = std::size_t(1) << 14;     // répertoire réservé d'avance
+const std::size_t MAX_BYTES  = std::size_t(1) << 30;     // texte cumulé (1 Gio)
+
+inline std::uint32_t hashText(const std::string& s) {
+    std::uint64_t h = 1469598103934665603ULL;            // FNV-1a 64
+    for (unsigned char c : s) { h ^= c; h *= 1099511628211ULL; }
+    return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+// Etat du pool. Le répertoire des blocs est réservé une fois pour toutes :
+// il ne se réalloue pas, ce qui permet à str() de lire sans verrou.
+// La table de recherche est en adressage ouvert : un slot de 64 bits
+// = (hash << 32) | (handle + 1), 0 = libre ; le hash stocké évite de
+// relire les chaînes lors d'un agrandissement.
+struct PoolState {
+    std::vector<std::unique_ptr<std::string[]>> chunks;
+    std::size_t count = 0;
+    std::size_t bytes = 0;
+    std::vector<std::uint64_t> slots;
+    std::mutex mutex;
+
+    PoolState() : slots(1024, 0) {
+        chunks.reserve(MAX_CHUNKS);
+        append(std::string());                           // handle 0 = chaîne vide
+    }
+
+    const std::string& at(StringPool::Handle h) const {
+        return chunks[h >> CHUNK_BITS][h & (CHUNK_SIZE - 1)];
+    }
+
+    // budget ou répertoire épuisé : refus avant toute modification (un emplace_back
+    // de plus réallouerait chunks sous les lecteurs de str())
+    StringPool::Handle append(const std::string& s) {
+        if (s.size() > MAX_BYTES - bytes)
+            throw std::length_error("StringPool: text budget exhausted");
+        if ((count & (CHUNK_SIZE - 1)) == 0) {
+            if (chunks.size() == MAX_CHUNKS)
+                throw std::length_error("StringPool: too many distinct strings");
+            chunks.emplace_back(new std::string[CHUNK_SIZE]);
+        }
+        StringPool::Handle h = static_cast<StringPool::Handle>(count++);
+        chunks[h >> CHUNK_BITS][h & (CHUNK_SIZE - 1)] = s;
+        bytes += s.size();
+        return h;
+    }
+
+    // slot de s : occupé par s, ou libre si s est absent
+    std::size_t probe(const std::string& s, std::uint32_t hash) const {
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+            std::uint64_t slot = slots[i];
+            if (slot == 0) return i;
+            if (static_cast<std::uint32_t>(slot >> 32) == hash &&
+                at(static_cast<StringPool::Handle>(slot) - 1) == s) return i;
+        }
+    }
+
+    void grow() {
+        std::vector<std::uint64_t> old(slots.size() * 2, 0);
+        old.swap(slots);
+        std::size_t mask = slots.size() - 1;
+        for (std::uint64_t slot : old) {
+            if (slot == 0) continue;
+            std::size_t i = static_cast<std::uint32_t>(slot >> 32) & mask;
+            while (slots[i] != 0) i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+};
+
+PoolState& state() {
+    static PoolState pool;
+    return pool;
+}
+
+}
+
+StringPool::Handle StringPool::intern(const std::string& s) {
+    if (s.empty()) return EMPTY;
+    std::uint32_t hash = hashText(s);
+    PoolState& pool = state();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    std::size_t i = pool.probe(s, hash);
+    if (pool.slots[i] != 0) return static_cast<Handle>(pool.slots[i]) - 1;
+    Handle h = pool.append(s);
+    pool.slots[i] = (static_cast<std::uint64_t>(hash) << 32) | (static_cast<std::uint64_t>(h) + 1);
+    if (pool.count * 2 > pool.slots.size()) pool.grow();           // charge <= 1/2
+    return h;
+}
+
+bool StringPool::find(const std::string& s, Handle& out) {
+    if (s.empty()) { out = EMPTY; return true; }
+    std::uint32_t hash = hashText(s);
+    PoolState& pool = state();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    std::size_t i = pool.probe(s, hash);
+    if (pool.slots[i] == 0) return false;
+    out = static_cast<Handle>(pool.slots[i]) - 1;
+    return true;
+}
+
+const std::string& StringPool::str(Handle h) {
+    return state().at(h);
+}
+
+std::size_t StringPool::size() {
+    PoolState& pool = state();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.count;
+}
+
+std::size_t StringPool::bytes() {
+    PoolState& pool = state();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    return pool.bytes;
+}
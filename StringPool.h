@@ -0,0 +1,62 @@
+// StringPool.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// ---------------------------------------------------------------------
+//  Pool global de chaînes internées (noms, classes).
+//
+//  Chaque chaîne distincte est stockée une seule fois, dans des blocs de
+//  taille fixe qui ne sont jamais déplacés ni libérés : une référence
+//  obtenue par str() reste valable jusqu'à la fin du programme. Un objet
+//  ne garde qu'un handle de 32 bits ; copier un Pipe ou un KC ne copie
+//  plus aucun texte.
+//
+//  intern / find prennent un verrou ; str() n'en prend pas (un handle
+//  n'est connu qu'après sa publication).
+//
+//  Rien n'est jamais rendu : un nom renommé, supprimé ou remplacé par un
+//  load reste dans le pool (pas de compteur de références, qui coûterait
+//  un verrou ou un atomique à chaque copie d'objet). Le pool ne croît
+//  donc qu'avec les textes distincts vus depuis le démarrage ; il est
+//  borné à 2^26 chaînes et 1 Gio de texte. Au-delà, intern lève
+//  std::length_error et le pool reste inchangé : en mode --batch ou
+//  serveur, la commande fautive répond "capacity exceeded" et les
+//  suivantes continuent (compteurs "strings" / "string_bytes" de stats).
+//  N'internez que des noms d'objets vivants : ni texte dérivé (index de
+//  recherche), ni noms générés à la volée.
+// ---------------------------------------------------------------------
+class StringPool {
+public:
+    typedef std::uint32_t Handle;
+    static const Handle EMPTY = 0;                 // handle de ""
+
+    static Handle intern(const std::string& s);
+    static bool   find(const std::string& s, Handle& out);   // sans insertion
+    static const std::string& str(Handle h);
+
+    // statistiques
+    static std::size_t size();                     // chaînes distinctes
+    static std::size_t bytes();                    // octets de texte
+};
+
+// Handle typé : se convertit en const std::string& partout où un nom est lu
+class PooledString {
+private:
+    StringPool::Handle h;
+public:
+    PooledString() : h(StringPool::EMPTY) {}
+    PooledString(const std::string& s) : h(StringPool::intern(s)) {}
+    PooledString(const char* s) : h(StringPool::intern(s)) {}
+
+    const std::string& str() const { return StringPool::str(h); }
+    operator const std::string&() const { return str(); }
+    StringPool::Handle handle() const { return h; }
+
+    bool operator==(const PooledString& o) const { return h == o.h; }
+    bool operator!=(const PooledString& o) const { return h != o.h; }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const PooledString& s) { return os << s.str(); }
@@ -0,0 +1,179 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+
+namespace {
+std::atomic<unsigned> sharedThreads(0);
+
+// worker courant : pool et indice de sa deque (nullptr hors des pools)
+thread_local const TaskScheduler* currentPool  = nullptr;
+thread_local unsigned             currentIndex = 0;
+thread_local unsigned             stealFrom    = 0;    // threads extérieurs : victime suivante
+}
+
+/*======================================================================
+   CONSTRUCTION / ARRÊT
+======================================================================*/
+TaskScheduler::TaskScheduler(unsigned count) : queued(0), sleeping(0), nextQueue(0) {
+    if (count == 0) count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < count; ++i) queues.emplace_back(new Queue());
+    for (unsigned i = 0; i < count; ++i) threads.emplace_back(&TaskScheduler::workerLoop, this, i);
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : threads) t.join();
+}
+
+TaskScheduler& TaskScheduler::shared() {
+    static TaskScheduler pool(sharedThreads.load());
+    return pool;
+}
+
+void TaskScheduler::setSharedThreadCount(unsigned n) { sharedThreads = n; }
+
+/*======================================================================
+   DEQUES – empiler, dépiler, voler
+======================================================================*/
+void TaskScheduler::push(Task task) {
+    unsigned target = currentPool == this
+                    ? currentIndex
+                    : nextQueue.fetch_add(1) % static_cast<unsigned>(queues.size());
+    queued.fetch_add(1);                               // avant l'ajout : jamais négatif
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->lock);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    if (sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_one();
+    }
+}
+
+bool TaskScheduler::runOne() {
+    if (queued.load() == 0) return false;
+    const unsigned n = static_cast<unsigned>(queues.size());
+    const bool inside = currentPool == this;
+    Task task;
+    if (inside) {                                      // sa propre deque, par la fin
+        Queue& own = *queues[currentIndex];
+        std::lock_guard<std::mutex> lock(own.lock);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    if (!task) {                                       // vol, par le début
+        unsigned start = inside ? currentIndex + 1 : stealFrom++;
+        for (unsigned k = 0; k < n && !task; ++k) {
+            Queue& victim = *queues[(start + k) % n];
+            if (inside && &victim == queues[currentIndex].get()) continue;
+            std::lock_guard<std::mutex> lock(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+    }
+    if (!task) return false;
+    queued.fetch_sub(1);
+    task();
+    return true;
+}
+
+// sleeping est incrémenté sous le verrou avant de tester la condition ;
+// push() et Group::finish() modifient leur compteur puis lisent sleeping
+void TaskScheduler::sleepUntil(const std::function<bool()>& ready) {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    ++sleeping;
+    wake.wait(lock, [&] { return ready() || queued.load() > 0; });
+    --sleeping;
+}
+
+void TaskScheduler::workerLoop(unsigned index) {
+    currentPool  = this;
+    currentIndex = index;
+    while (true) {
+        if (runOne()) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (stopping) return;                          // plus rien dans les deques
+        ++sleeping;
+        wake.wait(lock, [this] { return stopping || queued.load() > 0; });
+        --sleeping;
+    }
+}
+
+void TaskScheduler::submit(Task task) { push(std::move(task)); }
+
+/*======================================================================
+   GROUP – fork / join
+======================================================================*/
+TaskScheduler::Group::Group(TaskScheduler& scheduler_) : scheduler(scheduler_), pending(0) {}
+
+TaskScheduler::Group::~Group() {
+    try { wait(); } catch (...) {}
+}
+
+void TaskScheduler::Group::run(Task task) {
+    pending.fetch_add(1);
+    scheduler.push([this, task] {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+        finish();
+    });
+}
+
+// Après la décrémentation, le groupe peut être détruit par wait() :
+// plus aucun accès à ses membres
+void TaskScheduler::Group::finish() {
+    TaskScheduler& pool = scheduler;
+    if (pending.fetch_sub(1) != 1) return;
+    if (pool.sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(pool.sleepMutex);
+        pool.wake.notify_all();
+    }
+}
+
+void TaskScheduler::Group::wait() {
+    while (pending.load() != 0) {
+        if (scheduler.runOne()) continue;              // aide au lieu d'attendre
+        scheduler.sleepUntil([this] { return pending.load() == 0; });
+    }
+    std::exception_ptr first;
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        first = error;
+        error = nullptr;
+    }
+    if (first) std::rethrow_exception(first);
+}
+
+/*======================================================================
+   PARALLEL FOR – découpage binaire, moitié droite offerte au vol
+======================================================================*/
+void TaskScheduler::parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+                                const RangeBody& body) {
+    if (end <= begin) return;
+    if (grain == 0) grain = std::max<std::size_t>(1, (end - begin) / (8 * threadCount()));
+    if (end - begin <= grain) { body(begin, end); return; }
+    Group group(*this);
+    split(group, begin, end, grain, body);
+    group.wait();
+}
+
+void TaskScheduler::split(Group& group, std::size_t begin, std::size_t end, std::size_t grain,
+                          const RangeBody& body) {
+    while (end - begin > grain) {
+        std::size_t mid = begin + (end - begin) / 2;
+        group.run([this, &group, mid, end, grain, &body] { split(group, mid, end, grain, body); });
+        end = mid;
+    }
+    body(begin, end);
+}
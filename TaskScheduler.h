@@ -0,0 +1,111 @@
+// TaskScheduler.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------------------
+//  Pool de threads à vol de tâches, commun à tous les calculs parallèles
+//  (filtres de PipeStore, analyses du service de requêtes, …) : aucun
+//  module ne crée ses propres threads.
+//
+//  Chaque worker a sa deque : il empile et dépile ses tâches par la fin
+//  (LIFO, données encore en cache), un worker inoccupé vole par le début
+//  chez les autres (FIFO : les plus grosses parts d'un découpage
+//  récursif). Une tâche soumise hors du pool va dans une deque choisie à
+//  tour de rôle. Sans travail, les workers dorment sur une variable de
+//  condition.
+//
+//  Fork / join : Group::run() lance une tâche, Group::wait() attend les
+//  tâches du groupe en exécutant lui-même des tâches en attente (pas
+//  d'interblocage quand une tâche attend ses sous-tâches). La première
+//  exception levée par une tâche est relancée par wait().
+//
+//  parallelFor(begin, end, grain, body) : body(i0, i1) sur des tranches
+//  d'au plus grain indices, obtenues par découpage binaire récursif.
+// ---------------------------------------------------------------------
+class TaskScheduler {
+public:
+    typedef std::function<void()>                          Task;
+    typedef std::function<void(std::size_t, std::size_t)> RangeBody;
+
+    class Group {
+    private:
+        TaskScheduler&           scheduler;
+        std::atomic<std::size_t> pending;
+        std::mutex               errorMutex;
+        std::exception_ptr       error;
+
+        Group(const Group&);
+        Group& operator=(const Group&);
+
+        void finish();
+
+    public:
+        explicit Group(TaskScheduler& scheduler = TaskScheduler::shared());
+        ~Group();                                       // attend, sans relancer
+
+        void run(Task task);
+        void wait();                                    // relance la première exception
+        bool done() const { return pending.load() == 0; }
+    };
+
+private:
+    struct Queue {
+        std::mutex       lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;        // une par worker
+    std::vector<std::thread>            threads;
+    std::atomic<std::size_t>            queued;        // tâches dans les deques
+    std::atomic<unsigned>               sleeping;
+    std::atomic<unsigned>               nextQueue;     // soumissions externes
+    std::mutex                          sleepMutex;
+    std::condition_variable             wake;
+    bool                                stopping = false;
+
+    TaskScheduler(const TaskScheduler&);
+    TaskScheduler& operator=(const TaskScheduler&);
+
+    void push(Task task);
+    bool runOne();                                      // false : rien à exécuter
+    void sleepUntil(const std::function<bool()>& ready);
+    void workerLoop(unsigned index);
+    void split(Group& group, std::size_t begin, std::size_t end, std::size_t grain,
+               const RangeBody& body);
+
+public:
+    explicit TaskScheduler(unsigned threads = 0);      // 0 : hardware_concurrency
+    ~TaskScheduler();                                   // exécute les tâches restantes
+
+    unsigned threadCount() const { return static_cast<unsigned>(threads.size()); }
+
+    // Pool du processus ; setSharedThreadCount n'a d'effet qu'avant le
+    // premier appel à shared()
+    static TaskScheduler& shared();
+    static void           setSharedThreadCount(unsigned n);
+
+    // sans attente ni résultat ; une exception qui s'en échappe termine le
+    // programme, comme pour un std::thread (Group::run la transmet)
+    void submit(Task task);
+
+    // grain 0 : environ 8 tranches par worker
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, const RangeBody& body);
+
+    // a() et b() en parallèle, retour quand les deux sont terminées
+    template<typename A, typename B>
+    void invoke(A a, B b) {
+        Group group(*this);
+        group.run(b);
+        a();
+        group.wait();
+    }
+};
@@ -0,0 +1,139 @@
+#include "TrigramIndex.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+const char START = '\x01';   // marqueur de début de texte (jamais saisi)
+
+inline std::uint32_t packGram(const std::string& s, std::size_t i) {
+    return (static_cast<std::uint32_t>(static_cast<unsigned char>(s[i]))     << 16) |
+           (static_cast<std::uint32_t>(static_cast<unsigned char>(s[i + 1])) <<  8) |
+            static_cast<std::uint32_t>(static_cast<unsigned char>(s[i + 2]));
+}
+}
+
+std::string TrigramIndex::normalize(const std::string& text) {
+    std::string lower(text);
+    for (char& c : lower)
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    return lower;
+}
+
+// Trigrammes distincts de text ; anchored = avec les marqueurs de début
+void TrigramIndex::gramsOf(const std::string& text, bool anchored,
+                           std::vector<std::uint32_t>& out) {
+    out.clear();
+    std::string s = anchored ? std::string(2, START) + text : text;
+    for (std::size_t i = 0; i + 3 <= s.size(); ++i) out.push_back(packGram(s, i));
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+/*======================================================================
+   MAINTENANCE
+======================================================================*/
+void TrigramIndex::clear() {
+    postings.clear();
+    texts.clear();
+}
+
+// Construction en bloc : listes remplies dans le désordre puis triées une fois
+void TrigramIndex::assign(const std::vector<std::pair<int, std::string>>& items) {
+    clear();
+    texts.reserve(items.size());
+    std::vector<std::uint32_t> grams;
+    for (const auto& item : items) {
+        std::string text = normalize(item.second);
+        gramsOf(text, true, grams);
+        for (std::uint32_t g : grams) postings[g].push_back(item.first);
+        texts[item.first] = std::move(text);
+    }
+    for (auto& kv : postings) std::sort(kv.second.begin(), kv.second.end());
+}
+
+void TrigramIndex::upsert(int id, const std::string& text) {
+    std::string lower = normalize(text);
+    auto it = texts.find(id);
+    if (it != texts.end()) {
+        if (it->second == lower) return;
+        erase(id);
+    }
+    std::vector<std::uint32_t> grams;
+    gramsOf(lower, true, grams);
+    for (std::uint32_t g : grams) {
+        std::vector<int>& list = postings[g];
+        if (list.empty() || list.back() < id) list.push_back(id);
+        else list.insert(std::lower_bound(list.begin(), list.end(), id), id);
+    }
+    texts[id] = std::move(lower);
+}
+
+void TrigramIndex::erase(int id) {
+    auto it = texts.find(id);
+    if (it == texts.end()) return;
+    std::vector<std::uint32_t> grams;
+    gramsOf(it->second, true, grams);
+    for (std::uint32_t g : grams) {
+        auto p = postings.find(g);
+        if (p == postings.end()) continue;
+        std::vector<int>& list = p->second;
+        auto pos = std::lower_bound(list.begin(), list.end(), id);
+        if (pos != list.end() && *pos == id) list.erase(pos);
+        if (list.empty()) postings.erase(p);
+    }
+    texts.erase(it);
+}
+
+/*======================================================================
+   RECHERCHES
+======================================================================*/
+std::vector<int> TrigramIndex::candidates(const std::vector<std::uint32_t>& grams) const {
+    std::vector<const std::vector<int>*> lists;
+    for (std::uint32_t g : grams) {
+        auto it = postings.find(g);
+        if (it == postings.end()) return std::vector<int>();
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+    std::vector<int> result(*lists[0]), next;
+    for (std::size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        next.clear();
+        std::set_intersection(result.begin(), result.end(),
+                              lists[i]->begin(), lists[i]->end(), std::back_inserter(next));
+        result.swap(next);
+    }
+    return result;
+}
+
+std::vector<int> TrigramIndex::prefix(const std::string& pattern) const {
+    std::string p = normalize(pattern);
+    std::vector<int> found;
+    std::vector<std::uint32_t> grams;
+    gramsOf(p, true, grams);
+    if (grams.empty()) {                                 // préfixe vide : tout
+        for (const auto& kv : texts) found.push_back(kv.first);
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+    for (int id : candidates(grams))
+        if (texts.at(id).compare(0, p.size(), p) == 0) found.push_back(id);
+    return found;
+}
+
+std::vector<int> TrigramIndex::contains(const std::string& pattern) const {
+    std::string p = normalize(pattern);
+    std::vector<int> found;
+    std::vector<std::uint32_t> grams;
+    gramsOf(p, false, grams);
+    if (grams.empty()) {                                 // motif trop court : parcours
+        for (const auto& kv : texts)
+            if (kv.second.find(p) != std::string::npos) found.push_back(kv.first);
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+    for (int id : candidates(grams))
+        if (texts.at(id).find(p) != std::string::npos) found.push_back(id);
+    return found;
+}
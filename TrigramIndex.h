@@ -0,0 +1,45 @@
+// TrigramIndex.h
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------
+//  Index de trigrammes pour la recherche par préfixe et par sous-chaîne.
+//
+//  Chaque texte (en minuscules ASCII) est découpé en trigrammes ; chaque
+//  trigramme pointe vers la liste triée des IDs qui le contiennent. Le
+//  texte est préfixé de deux marqueurs de début, ce qui donne au moins un
+//  trigramme à toute recherche par préfixe, même d'un seul caractère.
+//
+//  Une requête intersecte les listes de ses trigrammes (la plus courte
+//  d'abord) puis vérifie les candidats sur le texte. Une sous-chaîne de
+//  moins de 3 caractères n'a pas de trigramme : parcours complet.
+//
+//  La recherche ignore la casse ASCII. Le texte normalisé est une copie
+//  privée, rendue par erase : il n'est pas interné, le StringPool ne
+//  libérant jamais rien. Résultats : IDs triés.
+// ---------------------------------------------------------------------
+class TrigramIndex {
+private:
+    std::unordered_map<std::uint32_t, std::vector<int>> postings;
+    std::unordered_map<int, std::string>               texts;   // texte normalisé
+
+    static std::string normalize(const std::string& text);
+    static void gramsOf(const std::string& text, bool anchored,
+                        std::vector<std::uint32_t>& out);
+    std::vector<int> candidates(const std::vector<std::uint32_t>& grams) const;
+
+public:
+    void assign(const std::vector<std::pair<int, std::string>>& items);
+    void upsert(int id, const std::string& text);
+    void erase(int id);
+    void clear();
+
+    std::size_t size() const { return texts.size(); }
+
+    std::vector<int> prefix(const std::string& pattern) const;
+    std::vector<int> contains(const std::string& pattern) const;
+};
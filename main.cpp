@@ -4,13 +4,25 @@
 #include <string>
 #include <limits>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <functional>
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 #include "Pipe.h"
 #include "KC.h"
 #include "Logger.h"
 #include "GasNetwork.h"
+#include "DataFile.h"
+#include "PipeStore.h"
+#include "CompanyIndex.h"
+#include "ScenarioOverlay.h"
+#include "CommandProcessor.h"
+#include "QueryServer.h"
+#include "DiskGraph.h"
+#include "AnalysisTask.h"
+#include "RedirectWrapper.h"
 
 using namespace std;
 
@@ -20,101 +32,48 @@ using namespace std;
 static inline void logAction(const std::string& action) { Logger::logAction(action); }
 
 /*======================================================================
-   SAVE / LOAD (inchangés)
+   Diamètres disponibles (seaux de pipes libres du réseau) ; false si aucun
 ======================================================================*/
-void saveToFile(const std::unordered_map<int, Pipe>& pipes,
-                const std::unordered_map<int, KC>& companies,
-                const std::string& filename) {
-    if (pipes.empty() && companies.empty()) {
-        std::cout << "Nothing to save: no pipes or companies in memory.\n";
-        logAction("Save aborted: nothing to save.");
-        return;
-    }
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cout << "Unable to open file for saving.\n";
-        logAction("Failed to open file for saving: " + filename);
-        return;
-    }
-    file << pipes.size() << std::endl;
-    for (const auto& kv : pipes) file << kv.second << std::endl;
-    file << companies.size() << std::endl;
-    for (const auto& kv : companies) file << kv.second << std::endl;
-
-    if (!file) {
-        std::cout << "Error occurred during saving.\n";
-        logAction("Error during saving: " + filename);
-    } else {
-        std::cout << "Data saved to file successfully.\n";
-        logAction("Saved data to file: " + filename);
-    }
+static bool showAvailableDiameters(const GasNetwork& network)
+{
+    std::vector<int> diameters = network.availableDiameters();
+    std::cout << "Available pipe diameters (unused pipes only): ";
+    for (size_t i = 0; i < diameters.size(); ++i)
+        std::cout << (i ? ", " : "") << diameters[i]
+                  << " (x" << network.unusedPipeCount(diameters[i]) << ")";
+    std::cout << "\n";
+    return !diameters.empty();
 }
 
-bool loadFromFile(std::unordered_map<int, Pipe>& pipes,
-                  std::unordered_map<int, KC>& companies,
-                  std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cout << "Unable to open file for loading.\n";
-        logAction("Failed to open file for loading: " + filename);
-        return false;
-    }
-    size_t nPipes = 0, nCompanies = 0;
-    if (!(file >> nPipes)) {
-        std::cout << "File corrupted or invalid format (pipes count).\n";
-        logAction("Corrupted file (pipes count): " + filename);
-        return false;
-    }
-    pipes.clear();
-    for (size_t i = 0; i < nPipes; ++i) {
-        Pipe p;
-        if (!(file >> p)) {
-            std::cout << "File corrupted or invalid format (pipe data).\n";
-            logAction("Corrupted file (pipe data): " + filename);
-            return false;
-        }
-        int id = p.getId();
-        if (id <= 0 || pipes.count(id)) {
-            std::cout << "Invalid or duplicate pipe ID found: " << id << '\n';
-            logAction("Invalid/duplicate pipe ID: " + std::to_string(id));
-            return false;
-        }
-        pipes[id] = p;
-        Logger::logAction("LOAD PIPE", p.getId(), p.getName(),
-                         p.getLength(), p.getDiameter(), p.isRepair());
-    }
-    if (!(file >> nCompanies)) {
-        std::cout << "File corrupted or invalid format (companies count).\n";
-        logAction("Corrupted file (companies count): " + filename);
-        return false;
-    }
-    companies.clear();
-    for (size_t i = 0; i < nCompanies; ++i) {
-        KC c;
-        if (!(file >> c)) {
-            std::cout << "File corrupted or invalid format (company data).\n";
-            logAction("Corrupted file (company data): " + filename);
-            return false;
+/*======================================================================
+   Import de connexions : contrôles de la saisie manuelle (KC existantes
+   et distinctes, tuyau encore libre, une seule fois dans le lot) avant
+   GasNetwork::addConnections. lineOf : ligne (1…) de chaque arête gardée ;
+   report : un message par arête écartée (nullptr : aucun)
+======================================================================*/
+static std::vector<ConnectionRecord> filterConnections(const std::vector<ConnectionRecord>& batch,
+                                                       const std::unordered_map<int, KC>& companies,
+                                                       const GasNetwork& network,
+                                                       std::vector<std::size_t>& lineOf,
+                                                       std::ostream* report)
+{
+    std::vector<ConnectionRecord> valid;
+    std::unordered_set<int>       pipesTaken;
+    lineOf.clear();
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        const ConnectionRecord& c = batch[i];
+        if (c.from == c.to || !companies.count(c.from) || !companies.count(c.to)) {
+            if (report) *report << "Line " << i + 1 << ": unknown or identical KC.\n";
+            continue;
         }
-        int id = c.getId();
-        if (id <= 0 || companies.count(id)) {
-            std::cout << "Invalid or duplicate company ID found: " << id << '\n';
-            logAction("Invalid/duplicate company ID: " + std::to_string(id));
-            return false;
+        if (network.isPipeUsed(c.pipe_id) || !pipesTaken.insert(c.pipe_id).second) {
+            if (report) *report << "Line " << i + 1 << ": pipe already in use.\n";
+            continue;
         }
-        companies[id] = c;
-        Logger::logAction("LOAD COMPANY", c.getId(), c.getName(),
-                          c.getWorkshop(), c.getWorkshopInOperation(),
-                          c.getClasses());
+        valid.push_back(c);
+        lineOf.push_back(i + 1);
     }
-    if (pipes.empty() && companies.empty()) {
-        std::cout << "Nothing loaded: file contains no pipes or companies.\n";
-        logAction("Load aborted: nothing in file.");
-        return false;
-    }
-    std::cout << "Data loaded from file successfully.\n";
-    logAction("Loaded data from file: " + filename);
-    return true;
+    return valid;
 }
 
 /*======================================================================
@@ -122,7 +81,9 @@ bool loadFromFile(std::unordered_map<int, Pipe>& pipes,
 ======================================================================*/
 static void showShortestPathOnly(GasNetwork& network,
                                  const std::unordered_map<int, Pipe>& pipes,
-                                 const std::unordered_map<int, KC>&   companies)
+                                 PipeStore& store,
+                                 const std::unordered_map<int, KC>&   companies,
+                                 CompanyIndex& companyIndex)
 {
     if (network.isEmpty()) {
         std::cout << "The network is empty – you cannot compute a path.\n";
@@ -133,20 +94,19 @@ static void showShortestPathOnly(GasNetwork& network,
         /* ----- créer au moins 2 companies ----- */
         while (companies.size() < 2) {
             std::cout << "Creating a new company (need at least 2).\n";
-            int newId = addCompany(const_cast<std::unordered_map<int, KC>&>(companies));
-            (void)newId;
+            int newId = addCompany(const_cast<std::unordered_map<int, KC>&>(companies),
+                                   companyIndex.allocator());
+            companyIndex.upsert(companies.at(newId));
         }
 
         /* ----- créer au moins 1 pipe ----- */
         if (pipes.empty()) {
             std::cout << "Creating a new pipe (need at least 1).\n";
-            int newId = addPipe(const_cast<std::unordered_map<int, Pipe>&>(pipes));
-            (void)newId;
+            int newId = addPipe(const_cast<std::unordered_map<int, Pipe>&>(pipes), store.allocator());
+            store.upsert(pipes.at(newId));
+            network.updatePipeInNetwork(newId);
         }
 
-        /* ----- enregistrer les pipes dans le réseau ----- */
-        for (const auto& kv : pipes)
-            network.registerPipe(kv.first, kv.second);
         std::cout << "Minimal data created. You can now request a shortest path.\n";
     }
 
@@ -218,7 +178,9 @@ static void showShortestPathOnly(GasNetwork& network,
    GESTION DU RÉSEAU (menu « Network Management »)
 ======================================================================*/
 void manageNetwork(std::unordered_map<int, Pipe>& pipes,
+                  PipeStore& store,
                   std::unordered_map<int, KC>&   companies,
+                  CompanyIndex& companyIndex,
                   GasNetwork& network)
 {
     int choice;
@@ -229,6 +191,9 @@ void manageNetwork(std::unordered_map<int, Pipe>& pipes,
         std::cout << "3. Topological sort\n";
         std::cout << "4. Analyze flow (max-flow + shortest path)\n";
         std::cout << "5. Find shortest path only\n";
+        std::cout << "6. Import connections from file\n";
+        std::cout << "7. What-if: pipes under repair\n";
+        std::cout << "8. Maximum flow with time limit\n";
         std::cout << "0. Back\n";
         std::cout << "Your choice: ";
         std::cin >> choice;
@@ -253,8 +218,8 @@ void manageNetwork(std::unordered_map<int, Pipe>& pipes,
                         std::cout << "Create a new company now? (1 for yes / 0 for no): ";
                     int create; std::cin >> create;
                     if (create == 1) {
-                        int newId = addCompany(companies);
-                        (void)newId;
+                        int newId = addCompany(companies, companyIndex.allocator());
+                        companyIndex.upsert(companies[newId]);
                     } else {
                         std::cout << "Cannot create a connection without enough companies.\n";
                         abort = true;
@@ -267,9 +232,9 @@ void manageNetwork(std::unordered_map<int, Pipe>& pipes,
                     std::cout << "No pipes exist. Create one now? (1 for yes / 0 for no): ";
                     int create; std::cin >> create;
                     if (create == 1) {
-                        int newId = addPipe(pipes);
-                        (void)newId;
-                        network.registerPipe(newId, pipes[newId]);   // enregistrement
+                        int newId = addPipe(pipes, store.allocator());
+                        store.upsert(pipes[newId]);
+                        network.updatePipeInNetwork(newId);
                     } else {
                         std::cout << "Cannot create a connection without any pipe.\n";
                         abort = true;
@@ -295,35 +260,15 @@ void manageNetwork(std::unordered_map<int, Pipe>& pipes,
                 }
 
                 /* ---------- 4️⃣  diamètres disponibles (pipes non‑utilisés) ---------- */
-                std::cout << "Available pipe diameters (unused pipes only): ";
-                bool first = true;
-                for (const auto& kv : pipes) {
-                    if (!network.isPipeUsed(kv.first)) {
-                        if (!first) std::cout << ", ";
-                        std::cout << kv.second.getDiameter();
-                        first = false;
-                    }
-                }
-                std::cout << "\n";
-
-                if (first) {   // aucun pipe libre
+                if (!showAvailableDiameters(network)) {   // aucun pipe libre
                     std::cout << "No unused pipes left. Create a new pipe? (1 for   yes / 0 for no): ";
                     int create; std::cin >> create;
                     if (create == 1) {
-                        int newId = addPipe(pipes);
-                        (void)newId;
-                        network.registerPipe(newId, pipes[newId]);
+                        int newId = addPipe(pipes, store.allocator());
+                        store.upsert(pipes[newId]);
+                        network.updatePipeInNetwork(newId);
                         std::cout << "New pipe added. Re‑displaying available diameters…\n";
-                        first = true;
-                        for (const auto& kv : pipes) {
-                            if (!network.isPipeUsed(kv.first)) {
-                                if (!first) std::cout << ", ";
-                                std::cout << kv.second.getDiameter();
-                                first = false;
-                            }
-                        }
-                        std::cout << "\n";
-                        if (first) {
+                        if (!showAvailableDiameters(network)) {
                             std::cout << "Still no unused pipes – aborting.\n";
                             break;
                         }
@@ -348,14 +293,8 @@ void manageNetwork(std::unordered_map<int, Pipe>& pipes,
                     }
                 }
 
-                /* ---------- 6️⃣  recherche du premier pipe libre du diamètre choisi ---------- */
-                int chosenPipeId = -1;
-                for (const auto& kv : pipes) {
-                    if (!network.isPipeUsed(kv.first) && kv.second.getDiameter() == desiredDiameter) {
-                        chosenPipeId = kv.first;
-                        break;          // le plus petit ID libre sera choisi
-                    }
-                }
+                /* ---------- 6️⃣  premier pipe libre du diamètre choisi (plus petit ID) ---------- */
+                int chosenPipeId = network.firstUnusedPipe(desiredDiameter);
                 if (chosenPipeId == -1) {
                     std::cout << "No unused pipe with that diameter. Try another diameter.\n";
                     break;
@@ -372,7 +311,6 @@ void manageNetwork(std::unordered_map<int, Pipe>& pipes,
                     logAction("Added connection: KC" + std::to_string(from_kc) +
                               " -> KC" + std::to_string(to_kc) +
                               " using pipe " + std::to_string(chosenPipeId));
-                    network.updatePipeInNetwork(chosenPipeId, pipes[chosenPipeId]);
                 } else {
                     std::cout << "Failed to create connection (would create cycle)!\n";
                 }
@@ -390,7 +328,7 @@ void manageNetwork(std::unordered_map<int, Pipe>& pipes,
                 break;
 
             /*-------------------------------------------------
-               3 – Topological sort (inchangée)
+               3 – Topological sort (ordre par niveaux)
               -------------------------------------------------*/
             case 3: {
                 if (network.isEmpty())
@@ -399,7 +337,9 @@ void manageNetwork(std::unordered_map<int, Pipe>& pipes,
                     std::cout << "Network contains cycles! Topological sort is impossible.\n";
                 else {
                     std::vector<int> sorted = network.topologicalSort(companies);
-                    if (!sorted.empty()) {
+                    if (sorted.empty())
+                        std::cout << "Topological sort failed: the network references unknown KCs.\n";
+                    else {
                         std::cout << "\nTopological sort result:\n";
                         for (size_t i = 0; i < sorted.size(); ++i)
                             std::cout << "KC " << sorted[i] << " (" << companies.at(sorted[i]).getName() << ")\n";
@@ -435,20 +375,117 @@ void manageNetwork(std::unordered_map<int, Pipe>& pipes,
                5 – Find shortest path only (déjà implémenté)
               -------------------------------------------------*/
             case 5: {
-                showShortestPathOnly(network, pipes, companies);
+                showShortestPathOnly(network, pipes, store, companies, companyIndex);
+                break;
+            }
+
+            /*-------------------------------------------------
+               6 – Import de connexions (from<TAB>to<TAB>pipe_id)
+              -------------------------------------------------*/
+            case 6: {
+                std::string file;
+                std::cout << "Enter connections file: ";
+                std::cin >> file;
+                std::vector<ConnectionRecord> batch;
+                if (!loadConnections(batch, file)) {
+                    std::cout << "Unable to open " << file << ".\n";
+                    break;
+                }
+                std::vector<std::size_t>      lineOf;
+                std::vector<ConnectionRecord> valid =
+                    filterConnections(batch, companies, network, lineOf, &std::cout);
+                const char* reasons[] = { "connection already exists", "unknown pipe",
+                                          "would create a cycle" };
+                std::vector<GasNetwork::RejectedConnection> rejected = network.addConnections(valid);
+                for (const auto& r : rejected)
+                    std::cout << "Line " << lineOf[r.index] << ": "
+                              << reasons[static_cast<int>(r.reason)] << ".\n";
+                std::size_t imported = valid.size() - rejected.size();
+                std::cout << imported << " of " << batch.size() << " connections imported.\n";
+                logAction("Imported " + std::to_string(imported) + " connections from " + file);
+                break;
+            }
+
+            /*-------------------------------------------------
+               7 – Scénario : tuyaux en réparation, réseau réel intact
+              -------------------------------------------------*/
+            case 7: {
+                if (network.isEmpty()) { std::cout << "Network is empty.\n"; break; }
+                ScenarioOverlay scenario;
+                std::cout << "Enter IDs of pipes to put under repair (end with -1): ";
+                int id;
+                while (std::cin >> id && id != -1) {
+                    auto it = pipes.find(id);
+                    if (it == pipes.end()) std::cout << "Pipe " << id << " not found, ignored.\n";
+                    else scenario.setRepair(it->second, true);
+                }
+                int source, sink;
+                std::cout << "Enter source KC: "; std::cin >> source;
+                std::cout << "Enter sink KC: ";   std::cin >> sink;
+                if (companies.find(source) == companies.end() ||
+                    companies.find(sink)   == companies.end()) {
+                    std::cout << "One or both KC IDs not found.\n";
+                    break;
+                }
+                std::vector<int> now   = network.findShortestPath(source, sink, pipes);
+                std::vector<int> after = network.findShortestPath(source, sink, pipes, &scenario);
+                std::cout << "\n--- What-if (" << scenario.changeCount() << " pipes under repair) ---\n";
+                std::cout << "Maximum flow   : " << network.calculateMaxFlow(source, sink)
+                          << " -> " << network.calculateMaxFlow(source, sink, &scenario) << " m^3/h\n";
+                std::cout << "Shortest path  : "
+                          << (now.empty() ? std::string("none") : std::to_string(now.size() - 1) + " hops")
+                          << " -> "
+                          << (after.empty() ? std::string("none") : std::to_string(after.size() - 1) + " hops")
+                          << "\n";
+                break;
+            }
+
+            /*-------------------------------------------------
+               8 – Débit maximal interruptible : échéance + progression
+              -------------------------------------------------*/
+            case 8: {
+                if (network.isEmpty()) { std::cout << "Network is empty.\n"; break; }
+                int source, sink;
+                double seconds;
+                std::cout << "Enter source KC: "; std::cin >> source;
+                std::cout << "Enter sink KC: ";   std::cin >> sink;
+                std::cout << "Time limit in seconds (0 = none): "; std::cin >> seconds;
+                if (companies.find(source) == companies.end() ||
+                    companies.find(sink)   == companies.end()) {
+                    std::cout << "One or both KC IDs not found.\n";
+                    break;
+                }
+                network.publish();
+                MaxFlowTask task(network.snapshot(), source, sink);
+                AnalysisTask::Clock::time_point deadline = AnalysisTask::Clock::time_point::max();
+                if (seconds > 0)
+                    deadline = AnalysisTask::Clock::now() +
+                               std::chrono::duration_cast<AnalysisTask::Clock::duration>(
+                                   std::chrono::duration<double>(seconds));
+                task.run(deadline, [&task](const AnalysisTask&) {
+                    std::cout << "  ... flow >= " << task.flow() << " m^3/h after "
+                              << task.steps() << " augmenting paths\n";
+                }, std::chrono::milliseconds(500));
+                if (task.status() == AnalysisTask::Status::Done)
+                    std::cout << "Maximum flow from KC " << source << " to KC " << sink
+                              << " : " << task.flow() << " m^3/h\n";
+                else
+                    std::cout << "Time limit reached: maximum flow is at least "
+                              << task.flow() << " m^3/h\n";
                 break;
             }
 
             case 0: break;
             default: std::cout << "Invalid choice.\n";
         }
+        network.publish();                  // version lue par les autres threads
     } while (choice != 0);
 }
 
 /*======================================================================
    SUPPRESSION DE PIPE / COMPANY (inchangés)
 ======================================================================*/
-void deletePipe(std::unordered_map<int, Pipe>& pipes, GasNetwork& network) {
+void deletePipe(std::unordered_map<int, Pipe>& pipes, PipeStore& store, GasNetwork& network) {
     if (pipes.empty()) { std::cout << "No pipes to delete.\n"; return; }
     std::cout << "Available pipes:\n";
     for (auto& kv : pipes) {
@@ -465,11 +502,13 @@ void deletePipe(std::unordered_map<int, Pipe>& pipes, GasNetwork& network) {
         else { std::cout << "Deletion cancelled.\n"; return; }
     }
     pipes.erase(id);
+    store.erase(id);
+    network.updatePipeInNetwork(id);            // retiré des tuyaux libres
     std::cout << "Pipe deleted successfully.\n";
     Logger::logAction("Deleted pipe " + std::to_string(id));
 }
 
-void deleteKC(std::unordered_map<int, KC>& companies, GasNetwork& network) {
+void deleteKC(std::unordered_map<int, KC>& companies, CompanyIndex& index, GasNetwork& network) {
     if (companies.empty()) { std::cout << "No companies to delete.\n"; return; }
     std::cout << "Available companies:\n";
     for (auto& kv : companies) {
@@ -484,6 +523,7 @@ void deleteKC(std::unordered_map<int, KC>& companies, GasNetwork& network) {
         return;
     }
     companies.erase(id);
+    index.erase(id);
     std::cout << "Company deleted successfully.\n";
     Logger::logAction("Deleted company " + std::to_string(id));
 }
@@ -491,11 +531,123 @@ void deleteKC(std::unordered_map<int, KC>& companies, GasNetwork& network) {
 /*======================================================================
    MAIN
 ======================================================================*/
-int main() {
+int main(int argc, char* argv[]) {
+    // --binary-log [fichier] : journal binaire au lieu de user_actions.log
+    // --batch [fichier]      : commandes JSON (fichier ou stdin), sans menu
+    // --serve unix:CHEMIN | tcp:PORT [--workers N] : service de requêtes local
+    // --load FICHIER, --connections FICHIER : données chargées avant --batch / --serve
+    // --disk FICHIER         : réseau sur disque (gennet -g), requêtes JSON en lecture
+    //                          seule (stdin ou fichier de --batch), rien d'autre en mémoire
+    bool batch = false, binaryLog = false;
+    std::string batchFile, serveAddress, loadFile, connectionsFile, diskFile;
+    unsigned workers = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--binary-log") {
+            std::string path = "user_actions.bin";
+            if (i + 1 < argc && argv[i + 1][0] != '-') path = argv[++i];
+            if (!Logger::useBinaryLog(path))
+                std::cout << "Unable to open binary log " << path
+                          << " (or not a binary log), using text log.\n";
+            else binaryLog = true;
+        } else if (arg == "--batch") {
+            batch = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') batchFile = argv[++i];
+        } else if (i + 1 < argc) {
+            if (arg == "--serve")            serveAddress = argv[++i];
+            else if (arg == "--workers")     workers = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (arg == "--load")        loadFile = argv[++i];
+            else if (arg == "--connections") connectionsFile = argv[++i];
+            else if (arg == "--disk")        diskFile = argv[++i];
+        }
+    }
+
+    if (!diskFile.empty()) {
+        std::ios::sync_with_stdio(false);
+        DiskGraph disk;
+        if (!disk.open(diskFile)) { std::cerr << "Unable to open disk network " << diskFile << "\n"; return 1; }
+        std::ifstream file;
+        if (!batchFile.empty()) {
+            file.open(batchFile);
+            if (!file.is_open()) { std::cerr << "Unable to open " << batchFile << "\n"; return 1; }
+        }
+        std::istream& in = batchFile.empty() ? std::cin : file;
+        std::string line, answer;
+        std::size_t count = 0, failed = 0;
+        while (std::getline(in, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            answer.clear();
+            try {
+                if (!CommandProcessor::answerDiskQuery(disk, line, answer)) ++failed;
+            } catch (const std::exception&) {          // mémoire : la requête échoue, pas le lot
+                answer = "{\"ok\":false,\"error\":\"internal error\"}\n";
+                ++failed;
+            }
+            std::cout << answer;
+            ++count;
+        }
+        std::cout.flush();
+        std::cerr << count << " commands, " << failed << " failed\n";
+        return 0;
+    }
+
     std::unordered_map<int, Pipe> pipes;
     std::unordered_map<int, KC>   companies;
-    GasNetwork network;
+    PipeStore pipeStore;                     // colonnes pour les filtres de pipes
+    CompanyIndex companyIndex;               // index nom / % inutilisé des KC
+    GasNetwork network(pipes);               // référence le registre, sans copie
     int choice;
+
+    if (batch || !serveAddress.empty()) {
+        std::ios::sync_with_stdio(false);   // avant de copier le tampon de std::cout
+        // réponses sur le tampon d'origine ; messages des menus (save/load) coupés,
+        // journal texte coupé (une ouverture de fichier par action)
+        std::ostream out(std::cout.rdbuf());
+        null_output_buffer nullBuf;
+        std::ostream nullOut(&nullBuf);
+        redirect_output_wrapper quiet(std::cout);
+        quiet.redirect(nullOut);
+        if (!binaryLog) Logger::setMuted(true);
+
+        if (!loadFile.empty()) {
+            if (!loadFromFile(pipes, companies, loadFile)) { std::cerr << "Unable to load " << loadFile << "\n"; return 1; }
+            pipeStore.assign(pipes);
+            network.refreshPipes();
+            companyIndex.assign(companies);
+        }
+        if (!connectionsFile.empty()) {
+            std::vector<ConnectionRecord> records;
+            if (!loadConnections(records, connectionsFile)) { std::cerr << "Unable to load " << connectionsFile << "\n"; return 1; }
+            std::vector<std::size_t>      lineOf;
+            std::vector<ConnectionRecord> valid = filterConnections(records, companies, network, lineOf, nullptr);
+            std::size_t rejected = records.size() - valid.size() + network.addConnections(valid).size();
+            std::cerr << records.size() - rejected << " connections loaded, " << rejected << " rejected\n";
+        }
+        CommandProcessor processor(pipes, companies, pipeStore, companyIndex, network);
+
+        if (!serveAddress.empty()) {
+            QueryServer server(processor, network, workers);
+            bool listening = false;
+            if (serveAddress.compare(0, 5, "unix:") == 0)     listening = server.listenUnix(serveAddress.substr(5));
+            else if (serveAddress.compare(0, 4, "tcp:") == 0) listening = server.listenTcp(std::atoi(serveAddress.c_str() + 4));
+            if (!listening) { std::cerr << "Unable to listen on " << serveAddress << "\n"; return 1; }
+            std::cerr << "Serving on " << serveAddress << "\n";
+            if (!server.run()) { std::cerr << "Server mode is not available on this platform\n"; return 1; }
+            Logger::flush();
+            return 0;
+        }
+
+        std::ifstream file;
+        if (!batchFile.empty()) {
+            file.open(batchFile);
+            if (!file.is_open()) { std::cerr << "Unable to open " << batchFile << "\n"; return 1; }
+        }
+        std::istream& in = batchFile.empty() ? std::cin : file;
+        std::size_t count = processor.run(in, out);
+        Logger::flush();
+        std::cerr << count << " commands, " << processor.failed() << " failed\n";
+        return 0;
+    }
     std::string filename = "data.txt";
 
     do {
@@ -523,34 +675,38 @@ int main() {
 
         switch (choice) {
             case 1: {
-                int newId = addPipe(pipes);
-                (void)newId;                         // silence warning
-                network.registerPipe(newId, pipes[newId]); // enregistrement du pipe
+                int newId = addPipe(pipes, pipeStore.allocator());
+                pipeStore.upsert(pipes[newId]);
+                network.updatePipeInNetwork(newId);          // nouveau tuyau libre
                 logAction("Added pipe");
                 break;
             }
             case 2: {
-                int newId = addCompany(companies);
-                (void)newId;
+                int newId = addCompany(companies, companyIndex.allocator());
+                companyIndex.upsert(companies[newId]);
                 logAction("Added company");
                 break;
             }
-            case 3: managePipes(pipes, network); break;
-            case 4: manageCompanies(companies);   break;
+            case 3: managePipes(pipes, pipeStore, network); break;
+            case 4: manageCompanies(companies, companyIndex, network); break;
             case 5: saveToFile(pipes, companies, filename); break;
             case 6: {
                 loadFromFile(pipes, companies, filename);
+                pipeStore.assign(pipes);
+                network.refreshPipes();
+                companyIndex.assign(companies);
                 break;
             }
             case 7: std::cout << "Enter filename: "; std::cin >> filename;
                     logAction("Set filename: " + filename);
                     break;
-            case 8: manageNetwork(pipes, companies, network); break;
-            case 9: deletePipe(pipes, network); break;
-            case 10: deleteKC(companies, network); break;
+            case 8: manageNetwork(pipes, pipeStore, companies, companyIndex, network); break;
+            case 9: deletePipe(pipes, pipeStore, network); break;
+            case 10: deleteKC(companies, companyIndex, network); break;
             case 0: std::cout << "Goodbye!\n"; logAction("Exited program"); break;
             default: std::cout << "Invalid choice.\n";
         }
+        network.publish();                  // version lue par les autres threads
     } while (choice != 0);
     return 0;
 }
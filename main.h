@@ -3,7 +3,9 @@
 #include "Pipe.h"
 #include "KC.h"
 #include "GasNetwork.h"
+#include "PipeStore.h"
+#include "CompanyIndex.h"
 
 // Functions to delete pipes and companies
-void deletePipe(std::unordered_map<int, Pipe>& pipes, GasNetwork& network);
-void deleteKC(std::unordered_map<int, KC>& companies, GasNetwork& network);
\ No newline at end of file
+void deletePipe(std::unordered_map<int, Pipe>& pipes, PipeStore& store, GasNetwork& network);
+void deleteKC(std::unordered_map<int, KC>& companies, CompanyIndex& index, GasNetwork& network);
\ No newline at end of file